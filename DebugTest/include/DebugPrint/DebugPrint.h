@@ -4,6 +4,11 @@
 // 定義しない場合はすべてのマクロが空になり、コードから除去される
 #define DEBUG_PRINT_ENABLED
 
+// このマクロを定義すると operator new/delete を置き換え、
+// PRINT_TRACE_FUNCTION のスコープごとにヒープ確保回数・確保バイト数を集計する。
+// 演算子の定義は DEBUG_PRINT_IMPLEMENTATION を定義した翻訳単位に置かれる
+//#define DEBUG_PRINT_TRACK_ALLOCATIONS
+
 #ifdef DEBUG_PRINT_ENABLED
 #include "detail/DebugPrintConfig.h"
 #include "detail/PrintMacroList.h"
@@ -14,12 +19,34 @@
 #define PRINT_MESSAGE(message)
 #define PRINT_WARNING_MESSAGE(message)
 #define PRINT_ERROR_MESSAGE(message)
+#define PRINT_MESSAGE_ONCE(message)
+#define PRINT_MESSAGE_EVERY_N(n, message)
+#define PRINT_MESSAGE_EVERY_MS(ms, message)
+#define PRINT_WARNING_MESSAGE_ONCE(message)
+#define PRINT_WARNING_MESSAGE_EVERY_N(n, message)
+#define PRINT_WARNING_MESSAGE_EVERY_MS(ms, message)
+#define PRINT_ERROR_MESSAGE_ONCE(message)
+#define PRINT_ERROR_MESSAGE_EVERY_N(n, message)
+#define PRINT_ERROR_MESSAGE_EVERY_MS(ms, message)
+#define DEBUG_PRINT_SUPPRESSED_SUMMARY()
+#define DEBUG_PRINT_THROTTLE_REPORT()
 #define POPUP_MESSAGE(message)
 #define POPUP_MESSAGE_ICON(message, icon)
 #define POPUP_WARNING_MESSAGE(message)
 #define POPUP_ERROR_MESSAGE(message)
+#define POPUP_MESSAGE_CALLBACK(message, onClosed)
+#define POPUP_MESSAGE_ICON_CALLBACK(message, icon, onClosed)
+#define POPUP_MESSAGE_BLOCKING(message)
+#define POPUP_MESSAGE_ICON_BLOCKING(message, icon)
+#define POPUP_WARNING_MESSAGE_BLOCKING(message)
+#define POPUP_ERROR_MESSAGE_BLOCKING(message)
 #define PRINT_VARIABLE(variable)
+#define PRINT_VARIABLE_SUMMARY(variable)
 #define PRINT_STRUCT(variable)
+#define PRINT_STRUCT_DIFF(variable)
+#define PRINT_MEMORY(address, size)
+#define PRINT_STRUCT_JSON(variable)
+#define PRINT_WATCH(variable)
 #define PRINT_TRACE_FUNCTION
 #define PRINT_TRACE_FUNCTION_COLOR(color)
 #define PRINT_TRACE_CLASS(name)
@@ -28,6 +55,12 @@
 #define DEBUG_SET_LANGUAGE_PATH(path)
 #define DEBUG_SET_DATETIME_FORMAT(format)
 #define DEBUG_SET_LOG_PATH(path)
+#define DEBUG_SET_COLLAPSE_DUPLICATES(enabled)
+#define DEBUG_SET_DUPLICATE_FLUSH_MS(ms)
+#define DEBUG_SET_THROTTLE_MESSAGES_PER_SEC(messagesPerSec)
+#define DEBUG_SET_THROTTLE_BYTES_PER_SEC(bytesPerSec)
+#define DEBUG_SET_THROTTLE_REPORT_MS(ms)
+#define DEBUG_SET_POPUP_MAX_PER_MINUTE(dialogsPerMinute)
 #define DEBUG_SET_EXIT_ON_ERROR(enabled)
 #define DEBUG_SET_PRINT_MESSAGE_COLOR(color)
 #define DEBUG_SET_PRINT_WARNING_MESSAGE_COLOR(color)
@@ -35,8 +68,29 @@
 #define DEBUG_SET_POPUP_MESSAGE_COLOR(color)
 #define DEBUG_SET_POPUP_WARNING_MESSAGE_COLOR(color)
 #define DEBUG_SET_POPUP_ERROR_MESSAGE_COLOR(color)
+#define DEBUG_SET_TRACE_CLASS_EVENTS(enabled)
+#define DEBUG_SET_TRACE_CLASS_LIFETIME(enabled)
+#define DEBUG_SET_SCOPE_PROFILE_REPORT(enabled)
+#define DEBUG_PRINT_SCOPE_PROFILE()
+#define DEBUG_SET_PERF_COUNTERS(enabled)
+#define DEBUG_SET_FLAME_GRAPH(enabled)
+#define DEBUG_SET_USER_TIMING(enabled)
+#define DEBUG_WRITE_FLAME_GRAPH(path)
+#define DEBUG_SET_PRINT_MAX_ELEMENTS(count)
+#define DEBUG_SET_PRINT_MAX_DEPTH(depth)
+#define DEBUG_SET_PRINT_COLUMNS(columns)
+#define DEBUG_SET_MEMORY_DUMP_MAX_BYTES(bytes)
+#define DEBUG_SET_MEMORY_DUMP_COLLAPSE(enabled)
+#define DEBUG_WATCH_TICK()
+#define DEBUG_UNWATCH(variable)
+#define DEBUG_CLEAR_WATCH()
 #define DEBUG_WRITE_LOG(path)
 #define DEBUG_CLEAR_LOG()
+#define DEBUG_SET_STRUCT_CAPTURE(enabled)
+#define DEBUG_SET_STRUCT_CAPTURE_MAX_BYTES(bytes)
+#define DEBUG_WRITE_STRUCT_CAPTURE(path)
+#define DEBUG_CLEAR_STRUCT_CAPTURE()
+#define PRINT_STRUCT_CAPTURE_FILE(filePath)
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "MacroList.h"
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace DebugPrint
+{
+    /// @brief スレッドごとのヒープ確保・解放の累計回数とバイト数。
+    /// DEBUG_PRINT_TRACK_ALLOCATIONS を定義すると operator new/delete から加算される。
+    /// FunctionTracer は開始時と終了時の値の差分からスコープ内の確保数を求める
+    struct AllocationCounters
+    {
+        uint64_t allocCount = 0;  // 確保回数
+        uint64_t allocBytes = 0;  // 確保バイト数
+        uint64_t freeCount  = 0;  // 解放回数
+
+        /// @brief 2つのスナップショットの差分を求める
+        [[nodiscard]] AllocationCounters operator-(const AllocationCounters& other) const
+        {
+            return { allocCount - other.allocCount, allocBytes - other.allocBytes, freeCount - other.freeCount };
+        }
+
+        /// @brief 差分を加算する
+        AllocationCounters& operator+=(const AllocationCounters& other)
+        {
+            allocCount += other.allocCount;
+            allocBytes += other.allocBytes;
+            freeCount  += other.freeCount;
+            return *this;
+        }
+    };
+
+    // 現在のスレッドのヒープ確保カウンタ。
+    // operator new 内から使用するため、動的初期化を持たない型にしておく
+    inline thread_local AllocationCounters t_AllocationCounters;
+
+    // operator new/delete の置き換えが組み込まれているかどうか。
+    // DEBUG_PRINT_TRACK_ALLOCATIONS を定義した実装側の翻訳単位で true になる
+    inline std::atomic<bool> g_AllocationHookInstalled{ false };
+
+    /// @brief 現在のスレッドのヒープ確保カウンタのスナップショットを取得する
+    [[nodiscard]] inline AllocationCounters GetThreadAllocationCounters() noexcept
+    {
+        return t_AllocationCounters;
+    }
+
+    /// @brief operator new/delete の置き換えが有効かどうかを取得する
+    [[nodiscard]] inline bool IsAllocationTrackingEnabled() noexcept
+    {
+        return g_AllocationHookInstalled.load(std::memory_order_relaxed);
+    }
+
+} // namespace DebugPrint
+
+
+// ===== operator new/delete の置き換え =====
+// グローバル演算子は1つの翻訳単位にしか定義できないため、
+// DEBUG_PRINT_IMPLEMENTATION を定義した翻訳単位でのみ定義する
+#if defined(DEBUG_PRINT_IMPLEMENTATION) && defined(DEBUG_PRINT_TRACK_ALLOCATIONS)
+
+namespace DebugPrint::detail
+{
+    // 確保・解放の関数はインライン展開しない。
+    // 置き換えた operator delete に free がインライン展開されると、GCC が operator new で確保した領域を
+    // free で解放していると判断して -Wmismatched-new-delete を出すため(実際の確保は malloc で行っている)
+
+    /// @brief メモリを確保し、成功した場合のみ確保を記録する
+    /// @return 確保した領域。失敗した場合は nullptr
+    DEBUG_PRINT_NOINLINE inline void* TrackedAllocate(std::size_t size) noexcept
+    {
+        void* ptr = std::malloc(size == 0 ? 1 : size);
+        if (ptr == nullptr) return nullptr;
+        ++t_AllocationCounters.allocCount;
+        t_AllocationCounters.allocBytes += size;
+        return ptr;
+    }
+
+    /// @brief 解放を記録してメモリを解放する
+    DEBUG_PRINT_NOINLINE inline void TrackedFree(void* ptr) noexcept
+    {
+        if (ptr == nullptr) return;
+        ++t_AllocationCounters.freeCount;
+        std::free(ptr);
+    }
+
+    /// @brief アライメントを指定したメモリを確保し、成功した場合のみ確保を記録する。
+    /// 解放は TrackedAlignedFree で行う(Windows では _aligned_malloc の領域を free で解放できないため)
+    /// @return 確保した領域。失敗した場合は nullptr
+    DEBUG_PRINT_NOINLINE inline void* TrackedAlignedAllocate(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        const std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_WIN32)
+        void* ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        // aligned_alloc はサイズがアライメントの倍数である必要がある
+        const std::size_t rounded = size == 0 ? align : (size + align - 1) / align * align;
+        void* ptr = rounded < size ? nullptr : std::aligned_alloc(align, rounded);
+#endif
+        if (ptr == nullptr) return nullptr;
+        ++t_AllocationCounters.allocCount;
+        t_AllocationCounters.allocBytes += size;
+        return ptr;
+    }
+
+    /// @brief 解放を記録して、アライメントを指定して確保したメモリを解放する
+    DEBUG_PRINT_NOINLINE inline void TrackedAlignedFree(void* ptr) noexcept
+    {
+        if (ptr == nullptr) return;
+        ++t_AllocationCounters.freeCount;
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    /// @brief 確保に成功するまで new_handler を呼び出して再試行する(標準の operator new と同じ動作)。
+    /// new_handler が設定されていない場合は std::bad_alloc を送出する
+    /// @param allocate 1回分の確保を行う関数
+    template <typename Allocate>
+    void* AllocateOrThrow(Allocate allocate)
+    {
+        while (true)
+        {
+            if (void* ptr = allocate()) return ptr;
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    /// @brief 例外を送出しない operator new の動作。
+    /// 標準と同じく、送出する版を呼び出して例外を nullptr に置き換える
+    template <typename Allocate>
+    void* AllocateOrNull(Allocate allocate) noexcept
+    {
+        try
+        {
+            return AllocateOrThrow(allocate);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+
+    // 起動時に置き換えが有効であることを記録する
+    inline const bool allocationHookRegistered = []
+    {
+        g_AllocationHookInstalled.store(true, std::memory_order_relaxed);
+        return true;
+    }();
+
+} // namespace DebugPrint::detail
+
+void* operator new(std::size_t size)
+{
+    return DebugPrint::detail::AllocateOrThrow([size] { return DebugPrint::detail::TrackedAllocate(size); });
+}
+
+void* operator new[](std::size_t size)
+{
+    return DebugPrint::detail::AllocateOrThrow([size] { return DebugPrint::detail::TrackedAllocate(size); });
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return DebugPrint::detail::AllocateOrNull([size] { return DebugPrint::detail::TrackedAllocate(size); });
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return DebugPrint::detail::AllocateOrNull([size] { return DebugPrint::detail::TrackedAllocate(size); });
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return DebugPrint::detail::AllocateOrThrow([=] { return DebugPrint::detail::TrackedAlignedAllocate(size, alignment); });
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return DebugPrint::detail::AllocateOrThrow([=] { return DebugPrint::detail::TrackedAlignedAllocate(size, alignment); });
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return DebugPrint::detail::AllocateOrNull([=] { return DebugPrint::detail::TrackedAlignedAllocate(size, alignment); });
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return DebugPrint::detail::AllocateOrNull([=] { return DebugPrint::detail::TrackedAlignedAllocate(size, alignment); });
+}
+
+void operator delete(void* ptr) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { DebugPrint::detail::TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { DebugPrint::detail::TrackedAlignedFree(ptr); }
+
+#endif
\ No newline at end of file
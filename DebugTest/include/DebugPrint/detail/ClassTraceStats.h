@@ -0,0 +1,233 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ColorDefine.h"
+#include "DebugPrintConfig.h"
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+
+namespace DebugPrint
+{
+    // 寿命ヒストグラムのバケット数。
+    // 1マイクロ秒未満から10秒以上までを10倍刻みで区切る
+    inline constexpr std::size_t CLASS_LIFETIME_BUCKET_COUNT = 9;
+
+    // 各バケットの表示ラベル
+    inline constexpr std::array<const char*, CLASS_LIFETIME_BUCKET_COUNT> CLASS_LIFETIME_BUCKET_LABELS =
+    {
+        "<1us", "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", "<10s", ">=10s"
+    };
+
+    /// @brief PRINT_TRACE_CLASS で追跡するクラス1種類分の統計情報。
+    /// 生存数・最大生存数・累計生成数はアトミックカウンタで管理するため、生成・破棄のたびにロックは取らない。
+    /// 寿命の計測を有効にした場合のみ、インスタンスごとの生成時刻をアドレスをキーにした表で保持し、
+    /// 破棄時に寿命を求めてヒストグラムに加算する
+    class ClassTraceStats
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief コンストラクタ
+        /// @param className 追跡するクラス名
+        /// @param color 表示色
+        ClassTraceStats(const char* className, Color color)
+            : m_ClassName(className), m_Color(color)
+        {
+        }
+
+        /// @brief インスタンスの生成を記録する
+        /// @param instance 生成されたインスタンスのアドレス
+        void OnConstruct(const void* instance)
+        {
+            m_TotalConstructed.fetch_add(1, std::memory_order_relaxed);
+            const uint64_t live = m_LiveCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            // 最大生存数を更新する
+            uint64_t peak = m_PeakCount.load(std::memory_order_relaxed);
+            while (live > peak &&
+                !m_PeakCount.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+
+            if (!DebugPrintConfig::GetInstance().IsTraceClassLifetimeEnabled()) return;
+
+            const Clock::time_point now = Clock::now();
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_BirthTimes[instance] = now;
+            m_TrackedCount.store(m_BirthTimes.size(), std::memory_order_relaxed);
+        }
+
+        /// @brief インスタンスの破棄を記録する
+        /// @param instance 破棄されるインスタンスのアドレス
+        void OnDestruct(const void* instance)
+        {
+            m_LiveCount.fetch_sub(1, std::memory_order_relaxed);
+
+            // 寿命を計測しているインスタンスがなければロックを取らずに戻る
+            if (m_TrackedCount.load(std::memory_order_relaxed) == 0) return;
+
+            Clock::time_point birth;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = m_BirthTimes.find(instance);
+                if (it == m_BirthTimes.end())
+                {
+                    return;
+                }
+                birth = it->second;
+                m_BirthTimes.erase(it);
+                m_TrackedCount.store(m_BirthTimes.size(), std::memory_order_relaxed);
+            }
+
+            const auto lifetime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - birth).count();
+            m_LifetimeHistogram[ToBucketIndex(lifetime)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// @brief 追跡するクラス名を取得する
+        [[nodiscard]] const char* GetClassName() const { return m_ClassName; }
+        /// @brief 表示色を取得する
+        [[nodiscard]] Color GetColor() const { return m_Color; }
+        /// @brief 現在の生存数を取得する
+        [[nodiscard]] uint64_t GetLiveCount() const { return m_LiveCount.load(std::memory_order_relaxed); }
+        /// @brief 最大生存数を取得する
+        [[nodiscard]] uint64_t GetPeakCount() const { return m_PeakCount.load(std::memory_order_relaxed); }
+        /// @brief 累計生成数を取得する
+        [[nodiscard]] uint64_t GetTotalConstructed() const { return m_TotalConstructed.load(std::memory_order_relaxed); }
+        /// @brief 寿命ヒストグラムに記録した件数の合計を取得する
+        [[nodiscard]] uint64_t GetLifetimeTotal() const
+        {
+            uint64_t total = 0;
+            for (const auto& count : m_LifetimeHistogram) total += count.load(std::memory_order_relaxed);
+            return total;
+        }
+        /// @brief 寿命ヒストグラムの指定バケットの件数を取得する
+        [[nodiscard]] uint64_t GetLifetimeCount(std::size_t bucket) const
+        {
+            return m_LifetimeHistogram[bucket].load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        /// @brief 寿命(マイクロ秒)からヒストグラムのバケット番号を求める
+        static std::size_t ToBucketIndex(long long microseconds)
+        {
+            std::size_t index = 0;
+            long long limit = 1;
+            while (index + 1 < CLASS_LIFETIME_BUCKET_COUNT && microseconds >= limit)
+            {
+                limit *= 10;
+                ++index;
+            }
+            return index;
+        }
+
+        const char* m_ClassName;  // 追跡するクラス名
+        Color       m_Color;      // 表示色
+
+        std::atomic<uint64_t> m_LiveCount{ 0 };         // 現在の生存数
+        std::atomic<uint64_t> m_PeakCount{ 0 };         // 最大生存数
+        std::atomic<uint64_t> m_TotalConstructed{ 0 };  // 累計生成数
+        std::array<std::atomic<uint64_t>, CLASS_LIFETIME_BUCKET_COUNT> m_LifetimeHistogram{};  // 寿命ヒストグラム
+
+        std::mutex m_Mutex;  // m_BirthTimes の排他制御用
+        std::unordered_map<const void*, Clock::time_point> m_BirthTimes;  // 寿命を計測中のインスタンスの生成時刻
+        std::atomic<std::size_t> m_TrackedCount{ 0 };  // m_BirthTimes の要素数(破棄時にロックが必要かの判定用)
+    };
+
+
+    /// @brief PRINT_TRACE_CLASS で追跡する全クラスの統計情報を保持するシングルトンクラス。
+    /// クラス名は型ごとに一度だけ登録され、追跡対象のオブジェクトには保持しない。
+    /// プログラム終了時(デストラクタ)に統計とリーク(未破棄インスタンス)を出力する
+    class ClassTraceRegistry
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static ClassTraceRegistry& GetInstance()
+        {
+            static ClassTraceRegistry instance;
+            return instance;
+        }
+
+        /// @brief クラスの統計情報を登録する。型ごとに一度だけ呼び出される
+        /// @param className 追跡するクラス名
+        /// @param color 表示色
+        /// @return 登録された統計情報
+        ClassTraceStats& Register(const char* className, Color color)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stats.push_back(std::make_unique<ClassTraceStats>(className, color));
+            return *m_Stats.back();
+        }
+
+        /// @brief 登録された全クラスの統計とリークをコンソールに出力する
+        void PrintReport() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (const auto& stats : m_Stats)
+            {
+                std::ostringstream out;
+                out << separatorString()
+                    << classReportString() << pairSeparatorString() << stats->GetClassName() << "\n"
+                    << liveCountString() << pairSeparatorString() << stats->GetLiveCount() << "\n"
+                    << peakCountString() << pairSeparatorString() << stats->GetPeakCount() << "\n"
+                    << totalConstructedString() << pairSeparatorString() << stats->GetTotalConstructed() << "\n";
+                // 寿命の計測が無効だった場合はヒストグラムを表示しない
+                if (stats->GetLifetimeTotal() > 0) out << lifetimeHistogramString() << pairSeparatorString() << "\n";
+                for (std::size_t i = 0; i < CLASS_LIFETIME_BUCKET_COUNT; ++i)
+                {
+                    const uint64_t count = stats->GetLifetimeCount(i);
+                    if (count == 0) continue;
+                    out << "  " << CLASS_LIFETIME_BUCKET_LABELS[i] << pairSeparatorString() << count << "\n";
+                }
+                PrintMessage(out.str(), stats->GetColor());
+
+                // 終了時に生存しているインスタンスはリークとして警告色で表示する
+                if (stats->GetLiveCount() > 0)
+                {
+                    std::ostringstream leak;
+                    leak << leakDetectedString() << pairSeparatorString()
+                         << stats->GetClassName() << " x" << stats->GetLiveCount() << "\n";
+                    PrintErrorMessage(leak.str(), DebugPrintConfig::GetInstance().GetPrintWarningMessageColor());
+                }
+                PrintMessage(separatorString(), stats->GetColor());
+            }
+        }
+
+        // コピー・ムーブ禁止
+        ClassTraceRegistry(const ClassTraceRegistry&) = delete;
+        ClassTraceRegistry& operator=(const ClassTraceRegistry&) = delete;
+        ClassTraceRegistry(ClassTraceRegistry&&) = delete;
+        ClassTraceRegistry& operator=(ClassTraceRegistry&&) = delete;
+
+    private:
+
+        /// @brief コンストラクタ。
+        /// 終了時のレポート出力で使用するシングルトンを先に生成し、
+        /// このインスタンスより後に破棄されるようにする
+        ClassTraceRegistry()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)DuplicateFilter::GetInstance();
+        }
+
+        /// @brief デストラクタ。プログラム終了時に統計とリークを出力する
+        ~ClassTraceRegistry()
+        {
+            PrintReport();
+        }
+
+        mutable std::mutex m_Mutex;  // m_Stats の排他制御用
+        std::vector<std::unique_ptr<ClassTraceStats>> m_Stats;  // 登録済みクラスの統計情報
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -18,6 +21,9 @@
 
 namespace DebugPrint
 {
+    // 前方宣言(PrintFunction.h で定義する)
+    inline bool DetectPopupAvailable();
+
     /// @brief デバッグ出力ライブラリのユーザー向け設定を管理するシングルトンクラス。
     /// カラー出力・ログファイル出力の有効・無効、言語切り替えの指示を担う。
     /// 各マクロの表示色・エラー時の終了有無もここで設定する。
@@ -55,6 +61,170 @@ namespace DebugPrint
         /// @brief エラー系マクロ呼び出し時に終了するかどうかを取得する
         [[nodiscard]] bool IsExitOnError() const { return m_ExitOnError; }
 
+        /// @brief PRINT_TRACE_CLASS で生成・破棄のたびにメッセージを出力するかを設定する。
+        /// 無効の場合も統計は記録され、プログラム終了時にまとめて出力される
+        /// @param enabled true で毎回出力する、false で統計のみ記録する
+        void SetTraceClassEvents(bool enabled) { m_TraceClassEvents = enabled; }
+
+        /// @brief PRINT_TRACE_CLASS で生成・破棄のたびにメッセージを出力するかを取得する
+        [[nodiscard]] bool IsTraceClassEventsEnabled() const { return m_TraceClassEvents; }
+
+        /// @brief PRINT_TRACE_CLASS でインスタンスごとの寿命を計測するかを設定する。
+        /// 有効な場合は生成・破棄のたびにロックを取って生成時刻を記録し、終了時に寿命ヒストグラムを出力する。
+        /// 無効の場合は生存数・最大生存数・累計生成数のみをアトミックカウンタで記録する
+        /// @param enabled true で寿命を計測する
+        void SetTraceClassLifetime(bool enabled) { m_TraceClassLifetime = enabled; }
+
+        /// @brief PRINT_TRACE_CLASS でインスタンスごとの寿命を計測するかを取得する
+        [[nodiscard]] bool IsTraceClassLifetimeEnabled() const { return m_TraceClassLifetime; }
+
+        /// @brief プログラム終了時に PRINT_TRACE_FUNCTION の呼び出し箇所ごとの集計を出力するかを設定する
+        /// @param enabled true で出力する
+        void SetScopeProfileReport(bool enabled) { m_ScopeProfileReport = enabled; }
+
+        /// @brief プログラム終了時に呼び出し箇所ごとの集計を出力するかを取得する
+        [[nodiscard]] bool IsScopeProfileReportEnabled() const { return m_ScopeProfileReport; }
+
+        /// @brief PRINT_TRACE_FUNCTION でパフォーマンスカウンタ(perf_event_open)を計測するかを設定する。
+        /// Linux 以外の環境では有効にしても何も出力されない
+        /// @param enabled true で計測する
+        void SetPerfCounters(bool enabled) { m_PerfCounters = enabled; }
+
+        /// @brief PRINT_TRACE_FUNCTION でパフォーマンスカウンタを計測するかを取得する
+        [[nodiscard]] bool IsPerfCountersEnabled() const { return m_PerfCounters; }
+
+        /// @brief PRINT_TRACE_FUNCTION のスコープをフレームグラフ用に集計するかを設定する
+        /// @param enabled true で集計する
+        void SetFlameGraph(bool enabled) { m_FlameGraph = enabled; }
+
+        /// @brief PRINT_TRACE_FUNCTION のスコープをフレームグラフ用に集計するかを取得する
+        [[nodiscard]] bool IsFlameGraphEnabled() const { return m_FlameGraph; }
+
+        /// @brief PRINT_TRACE_FUNCTION のスコープを User Timing(performance.measure)として記録するかを設定する。
+        /// 有効な場合はテキストを出力せず、ブラウザの開発者ツールのパフォーマンスパネルや Node.js の perf_hooks で確認する。
+        /// Emscripten 環境でのみ有効
+        /// @param enabled true で記録する
+        void SetUserTiming(bool enabled) { m_UserTiming = enabled; }
+
+        /// @brief PRINT_TRACE_FUNCTION のスコープを User Timing として記録するかを取得する。
+        /// Emscripten 以外では常に false を返す
+        [[nodiscard]] bool IsUserTimingEnabled() const
+        {
+#if defined(__EMSCRIPTEN__)
+            return m_UserTiming;
+#else
+            return false;
+#endif
+        }
+
+        /// @brief PRINT_VARIABLE・PRINT_STRUCT でコンテナ1つにつき表示する最大要素数を設定する。
+        /// 超えた分は先頭と末尾を残して省略される
+        /// @param maxElements 最大要素数
+        void SetPrintMaxElements(std::size_t maxElements) { m_PrintMaxElements = maxElements; }
+
+        /// @brief コンテナ1つにつき表示する最大要素数を取得する
+        [[nodiscard]] std::size_t GetPrintMaxElements() const { return m_PrintMaxElements; }
+
+        /// @brief PRINT_VARIABLE・PRINT_STRUCT で入れ子のコンテナを展開する最大の深さを設定する
+        /// @param maxDepth 最大の深さ
+        void SetPrintMaxDepth(std::size_t maxDepth) { m_PrintMaxDepth = maxDepth; }
+
+        /// @brief 入れ子のコンテナを展開する最大の深さを取得する
+        [[nodiscard]] std::size_t GetPrintMaxDepth() const { return m_PrintMaxDepth; }
+
+        /// @brief PRINT_VARIABLE で数値の配列を表示するときに1行に並べる要素数を設定する。
+        /// 1 の場合は従来どおり1要素につき1行で表示する
+        /// @param columns 1行に並べる要素数
+        void SetPrintColumns(std::size_t columns) { m_PrintColumns = columns > 0 ? columns : 1; }
+
+        /// @brief 数値の配列を表示するときに1行に並べる要素数を取得する
+        [[nodiscard]] std::size_t GetPrintColumns() const { return m_PrintColumns; }
+
+        /// @brief PRINT_MEMORY で表示する最大バイト数を設定する。超えた分は省略したバイト数のみを表示する
+        /// @param maxBytes 最大バイト数
+        void SetMemoryDumpMaxBytes(std::size_t maxBytes) { m_MemoryDumpMaxBytes = maxBytes; }
+
+        /// @brief PRINT_MEMORY で表示する最大バイト数を取得する
+        [[nodiscard]] std::size_t GetMemoryDumpMaxBytes() const { return m_MemoryDumpMaxBytes; }
+
+        /// @brief PRINT_MEMORY で直前の行と同じ内容の行を "*" にまとめるかを設定する
+        /// @param enabled true でまとめる
+        void SetMemoryDumpCollapse(bool enabled) { m_MemoryDumpCollapse = enabled; }
+
+        /// @brief PRINT_MEMORY で同じ内容の行をまとめるかどうかを取得する
+        [[nodiscard]] bool IsMemoryDumpCollapseEnabled() const { return m_MemoryDumpCollapse; }
+
+        /// @brief 同じメッセージが連続したときに2回目以降を省略し、繰り返し回数のみを表示するかを設定する
+        /// @param enabled true で省略する
+        void SetCollapseDuplicates(bool enabled) { m_CollapseDuplicates = enabled; }
+
+        /// @brief 同じメッセージの連続を省略するかどうかを取得する
+        [[nodiscard]] bool IsCollapseDuplicatesEnabled() const { return m_CollapseDuplicates; }
+
+        /// @brief 同じメッセージが続いている間、繰り返し回数を表示する間隔を設定する
+        /// @param ms 間隔(ミリ秒)
+        void SetDuplicateFlushMs(uint32_t ms) { m_DuplicateFlushMs = ms; }
+
+        /// @brief 繰り返し回数を表示する間隔(ミリ秒)を取得する
+        [[nodiscard]] uint32_t GetDuplicateFlushMs() const { return m_DuplicateFlushMs; }
+
+        /// @brief PRINT_MESSAGE・PRINT_WARNING_MESSAGE・PRINT_ERROR_MESSAGE の呼び出し箇所ごとの
+        /// 1秒あたりの最大メッセージ数を設定する。超えた呼び出し箇所は自動で間引かれる
+        /// @param messagesPerSec 1秒あたりの最大メッセージ数(0 で制限しない)
+        void SetThrottleMessagesPerSec(uint64_t messagesPerSec) { m_ThrottleMessagesPerSec = messagesPerSec; }
+
+        /// @brief 呼び出し箇所ごとの1秒あたりの最大メッセージ数を取得する
+        [[nodiscard]] uint64_t GetThrottleMessagesPerSec() const { return m_ThrottleMessagesPerSec; }
+
+        /// @brief PRINT_MESSAGE・PRINT_WARNING_MESSAGE・PRINT_ERROR_MESSAGE の呼び出し箇所ごとの
+        /// 1秒あたりの最大バイト数を設定する。超えた呼び出し箇所は自動で間引かれる
+        /// @param bytesPerSec 1秒あたりの最大バイト数(0 で制限しない)
+        void SetThrottleBytesPerSec(uint64_t bytesPerSec) { m_ThrottleBytesPerSec = bytesPerSec; }
+
+        /// @brief 呼び出し箇所ごとの1秒あたりの最大バイト数を取得する
+        [[nodiscard]] uint64_t GetThrottleBytesPerSec() const { return m_ThrottleBytesPerSec; }
+
+        /// @brief 間引いた回数の多い呼び出し箇所を出力する間隔を設定する
+        /// @param ms 間隔(ミリ秒)
+        void SetThrottleReportMs(uint32_t ms) { m_ThrottleReportMs = ms; }
+
+        /// @brief 間引いた回数の多い呼び出し箇所を出力する間隔(ミリ秒)を取得する
+        [[nodiscard]] uint32_t GetThrottleReportMs() const { return m_ThrottleReportMs; }
+
+        /// @brief ポップアップのダイアログを表示できる環境かどうかを取得する。
+        /// 判定には補助プログラムの確認などのプロセス起動を伴うため、最初のポップアップの表示時に1度だけ判定し、
+        /// 結果を保持する。表示できない場合、POPUP_* マクロはダイアログを開かずにコンソールにのみ表示する
+        /// @return ダイアログを表示できる場合は true
+        [[nodiscard]] bool IsPopupAvailable() const
+        {
+            std::call_once(m_PopupAvailableOnce, [this] { m_PopupAvailable = DetectPopupAvailable(); });
+            return m_PopupAvailable;
+        }
+
+        /// @brief 1分あたりに表示するポップアップの最大数を設定する。
+        /// 超えた分はダイアログを開かず、コンソールにのみ表示する
+        /// @param dialogsPerMinute 1分あたりの最大数(0 で制限しない)
+        void SetPopupMaxPerMinute(uint32_t dialogsPerMinute) { m_PopupMaxPerMinute = dialogsPerMinute; }
+
+        /// @brief 1分あたりに表示するポップアップの最大数を取得する
+        [[nodiscard]] uint32_t GetPopupMaxPerMinute() const { return m_PopupMaxPerMinute; }
+
+        /// @brief PRINT_STRUCT の記録モードを設定する。
+        /// 有効な場合、トリビアルにコピー可能な構造体は表示せずにバイト列のまま StructCapture に記録する
+        /// @param enabled true で記録する
+        void SetStructCapture(bool enabled) { m_StructCapture = enabled; }
+
+        /// @brief PRINT_STRUCT の記録モードが有効かどうかを取得する
+        [[nodiscard]] bool IsStructCaptureEnabled() const { return m_StructCapture; }
+
+        /// @brief PRINT_STRUCT の記録モードで蓄積する記録の最大バイト数を設定する。
+        /// 上限に達した後の記録は破棄し、最初に破棄したときに一度だけ警告を表示する
+        /// @param maxBytes 最大バイト数(0 で制限しない)
+        void SetStructCaptureMaxBytes(std::size_t maxBytes) { m_StructCaptureMaxBytes = maxBytes; }
+
+        /// @brief PRINT_STRUCT の記録モードで蓄積する記録の最大バイト数を取得する
+        [[nodiscard]] std::size_t GetStructCaptureMaxBytes() const { return m_StructCaptureMaxBytes; }
+
         // --- 各マクロの表示色設定 ---
 
         /// @brief PRINT_MESSAGE の表示色を設定する
@@ -154,7 +324,28 @@ namespace DebugPrint
 
         std::string m_LogPath = "./logs/";  // ログファイルの出力先パス
         bool        m_ColorOutputAvailable; // 端末がカラー出力に対応しているかどうか
+        mutable std::once_flag m_PopupAvailableOnce;     // ポップアップの表示可否の判定を1度だけ行うためのフラグ
+        mutable bool           m_PopupAvailable = false;  // ポップアップのダイアログを表示できるかどうか
         bool        m_ExitOnError = false;  // エラー系マクロ呼び出し時の終了有無
+        bool        m_TraceClassEvents = false;  // PRINT_TRACE_CLASS の生成・破棄ごとの出力有無
+        bool        m_TraceClassLifetime = false;  // PRINT_TRACE_CLASS のインスタンスごとの寿命計測の有無
+        bool        m_ScopeProfileReport = false;  // 終了時のスコープ集計出力の有無
+        bool        m_PerfCounters = false;  // PRINT_TRACE_FUNCTION でのパフォーマンスカウンタ計測の有無
+        bool        m_FlameGraph = false;    // PRINT_TRACE_FUNCTION のフレームグラフ集計の有無
+        bool        m_UserTiming = false;    // PRINT_TRACE_FUNCTION を User Timing として記録するかどうか(Emscripten のみ)
+        std::size_t m_PrintMaxElements = 100;  // コンテナ1つにつき表示する最大要素数
+        std::size_t m_PrintMaxDepth = 3;       // 入れ子のコンテナを展開する最大の深さ
+        std::size_t m_PrintColumns = 1;        // 数値の配列を表示するときに1行に並べる要素数
+        std::size_t m_MemoryDumpMaxBytes = 4096;  // PRINT_MEMORY で表示する最大バイト数
+        bool m_MemoryDumpCollapse = true;         // PRINT_MEMORY で同じ内容の行をまとめるかどうか
+        bool m_StructCapture = false;             // PRINT_STRUCT で構造体を表示せずに記録するかどうか
+        std::size_t m_StructCaptureMaxBytes = std::size_t(64) << 20;  // 構造体の記録を蓄積する最大バイト数(0 で制限しない)
+        bool m_CollapseDuplicates = true;         // 同じメッセージの連続を省略するかどうか
+        uint32_t m_DuplicateFlushMs = 1000;       // 同じメッセージが続いている間に繰り返し回数を表示する間隔(ミリ秒)
+        uint64_t m_ThrottleMessagesPerSec = 1000;  // 呼び出し箇所ごとの1秒あたりの最大メッセージ数(0 で制限しない)
+        uint64_t m_ThrottleBytesPerSec = 1 << 20;  // 呼び出し箇所ごとの1秒あたりの最大バイト数(0 で制限しない)
+        uint32_t m_ThrottleReportMs = 5000;        // 間引いた呼び出し箇所を出力する間隔(ミリ秒)
+        uint32_t m_PopupMaxPerMinute = 10;         // 1分あたりに表示するポップアップの最大数(0 で制限しない)
 
         // 各マクロの表示色
         Color m_PrintMessageColor           = PRINT_COLOR::DEFAULT;    // PRINT_MESSAGE の表示色
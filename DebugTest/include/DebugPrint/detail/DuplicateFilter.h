@@ -0,0 +1,182 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#if defined(DEBUG_PRINT_HAS_THREADS)
+#include <thread>
+#endif
+
+#include "MacroList.h"
+#include "ColorDefine.h"
+#include "TemplateStrings.h"
+#include "DebugPrintConfig.h"
+#include "FormatBuffer.h"
+
+namespace DebugPrint
+{
+    // 前方宣言(PrintFunction.h で定義する)
+    inline std::mutex& GetOutputMutex();
+    inline void WriteOutput(const std::string& message, Color color, bool toStderr);
+
+    /// @brief 同じメッセージが連続して出力されるとき、2回目以降を出力せずに回数だけ数えるシングルトンクラス。
+    /// 連続が途切れたとき、または一定時間ごとに「直前のメッセージの繰り返し回数: N」を1行出力する。
+    /// 同一かどうかは書式化済みのメッセージのハッシュ値・長さ・色・出力先で判定するため、
+    /// 前回のメッセージ本文は保持せず、比較も定数時間で済む
+    class DuplicateFilter
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static DuplicateFilter& GetInstance()
+        {
+            static DuplicateFilter instance;
+            return instance;
+        }
+
+        /// @brief 出力しようとするメッセージが直前のメッセージと同じかを判定する。
+        /// 同じ場合は回数を数えて true を返す。異なる場合は、保留中の繰り返し回数があれば先に出力して false を返す
+        /// @param message 出力するメッセージ
+        /// @param color 表示色
+        /// @param toStderr 標準エラー出力に出力する場合は true
+        /// @return 出力を省略する場合は true
+        bool Filter(const std::string& message, Color color, bool toStderr)
+        {
+            const DebugPrintConfig& config = DebugPrintConfig::GetInstance();
+            const bool enabled = config.IsCollapseDuplicatesEnabled();
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (!enabled)
+            {
+                FlushLocked();
+                m_HasLast = false;
+                return false;
+            }
+
+            const std::size_t hash = std::hash<std::string_view>{}(message);
+            if (m_HasLast && hash == m_LastHash && message.size() == m_LastSize &&
+                color == m_LastColor && toStderr == m_LastToStderr)
+            {
+                if (m_Repeats++ == 0)
+                {
+                    // 繰り返しの始まりから一定時間後に回数を出力する
+                    m_FlushInterval = std::chrono::milliseconds(config.GetDuplicateFlushMs());
+                    m_RunStart      = std::chrono::steady_clock::now();
+                    StartTimer();
+                    m_Condition.notify_one();
+                }
+                return true;
+            }
+
+            FlushLocked();
+            m_HasLast      = true;
+            m_LastHash     = hash;
+            m_LastSize     = message.size();
+            m_LastColor    = color;
+            m_LastToStderr = toStderr;
+            return false;
+        }
+
+        /// @brief 保留中の繰り返し回数があれば出力する
+        void Flush()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            FlushLocked();
+        }
+
+        // コピー・ムーブ禁止
+        DuplicateFilter(const DuplicateFilter&) = delete;
+        DuplicateFilter& operator=(const DuplicateFilter&) = delete;
+        DuplicateFilter(DuplicateFilter&&) = delete;
+        DuplicateFilter& operator=(DuplicateFilter&&) = delete;
+
+    private:
+
+        /// @brief コンストラクタ。
+        /// 終了時の出力で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+        DuplicateFilter()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)GetOutputMutex();
+        }
+
+        /// @brief デストラクタ。タイマースレッドを止め、保留中の繰り返し回数を出力する
+        ~DuplicateFilter()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Condition.notify_one();
+#if defined(DEBUG_PRINT_HAS_THREADS)
+            if (m_Timer.joinable()) m_Timer.join();
+#endif
+            Flush();
+        }
+
+        /// @brief 繰り返し回数を1行出力し、回数を0に戻す。m_Mutex を保持した状態で呼ぶ。
+        /// 直前のメッセージの情報は残すため、同じメッセージが続く間は引き続き省略される
+        void FlushLocked()
+        {
+            if (m_Repeats == 0) return;
+
+            ScopedFormatBuffer buffer;
+            std::string& out = buffer.Get();
+            out += messageRepeatedString();
+            out += pairSeparatorString();
+            AppendValue(out, m_Repeats);
+            out += '\n';
+            m_Repeats = 0;
+            WriteOutput(out, m_LastColor, m_LastToStderr);
+        }
+
+        /// @brief 繰り返しが続いたまま出力が止まった場合にも回数を出力するタイマースレッドを起動する。
+        /// スレッドを使えない環境では、次に異なるメッセージを出力したときとプログラム終了時に出力する
+        void StartTimer()
+        {
+#if defined(DEBUG_PRINT_HAS_THREADS)
+            if (m_Timer.joinable()) return;
+            m_Timer = std::thread([this]
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                while (!m_Stop)
+                {
+                    if (m_Repeats == 0)
+                    {
+                        m_Condition.wait(lock);
+                        continue;
+                    }
+                    const auto deadline = m_RunStart + m_FlushInterval;
+                    if (m_Condition.wait_until(lock, deadline) == std::cv_status::timeout &&
+                        m_Repeats > 0 && std::chrono::steady_clock::now() >= m_RunStart + m_FlushInterval)
+                    {
+                        FlushLocked();
+                    }
+                }
+            });
+#endif
+        }
+
+        std::mutex              m_Mutex;      // 全メンバーの排他制御用
+        std::condition_variable m_Condition;  // タイマースレッドの起床用
+#if defined(DEBUG_PRINT_HAS_THREADS)
+        std::thread             m_Timer;      // 一定時間ごとに繰り返し回数を出力するスレッド
+#endif
+        bool        m_Stop         = false;  // タイマースレッドの終了要求
+        bool        m_HasLast      = false;  // 直前のメッセージの情報があるかどうか
+        std::size_t m_LastHash     = 0;      // 直前のメッセージのハッシュ値
+        std::size_t m_LastSize     = 0;      // 直前のメッセージの長さ
+        Color       m_LastColor    = PRINT_COLOR::DEFAULT;  // 直前のメッセージの表示色
+        bool        m_LastToStderr = false;  // 直前のメッセージの出力先が標準エラー出力かどうか
+        uint64_t    m_Repeats      = 0;      // 直前のメッセージを省略した回数
+        std::chrono::steady_clock::time_point m_RunStart;  // 繰り返しの始まり(または前回の回数の出力)の時刻
+        std::chrono::milliseconds m_FlushInterval{ 1000 };  // 繰り返し回数を出力する間隔
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "ColorDefine.h"
 
 #if defined(__EMSCRIPTEN__)
+#include <cstdint>
 #include <emscripten.h>
 
 /// @brief Emscripten 環境で使用する JavaScript 関数の定義をまとめたファイル。
@@ -36,16 +37,133 @@ EM_JS(void, js_register_helpers, (), {
     // sweetalert2 が --pre-js でモジュールスコープに読み込まれるため
     // globalThis.Swal として登録する
     globalThis.Swal = globalThis.Sweetalert2;
+
+    // デコード済みのメッセージ1件を表示先に渡す関数を登録する。
+    // ページにログビューア(debugPrintViewer)がある場合はその記録に追加し、
+    // ない場合は debugPrintOutput に溜めて次の描画フレームでまとめて #output に反映する。
+    // #output がない環境(Node.js など)では標準出力・標準エラー出力に書き込む
+    globalThis.debugPrintWrite = function(text, color, isError) {
+        if (globalThis.debugPrintViewer) {
+            globalThis.debugPrintViewer.append(text, color, isError);
+            return;
+        }
+        var output = typeof document !== 'undefined' ? document.getElementById('output') : null;
+        if (output) {
+            globalThis.debugPrintOutput.append(text, color);
+        } else if (typeof process !== 'undefined' && process.stdout) {
+            (isError ? process.stderr : process.stdout).write(text);
+        } else if (isError) {
+            console.error(text);
+        } else {
+            console.log(text);
+        }
+    };
+
+    // #output への出力をまとめて反映するバッファを登録する。
+    // js_print / js_print_error は文字列を溜めるだけで、DOM の更新は requestAnimationFrame ごとに1回にまとめる。
+    // 隣り合う同じ色の出力は1つの span にまとめ、表示する文字数が上限を超えたら古い順に削除する
+    globalThis.debugPrintOutput = {
+        maxChars     : 500000,  // #output に残す最大文字数
+        runs         : [],      // 未反映の出力。色ごとに { css, parts, length } の形でまとめる
+        pendingChars : 0,       // 未反映の出力の文字数
+        shownChars   : 0,       // #output に表示している文字数
+        scheduled    : false,   // 反映を予約済みかどうか
+
+        append : function(text, color) {
+            if (text.length === 0) return;
+            var css  = globalThis.makeColorCode(color) || '';
+            var last = this.runs.length > 0 ? this.runs[this.runs.length - 1] : null;
+            if (last && last.css === css) {
+                last.parts.push(text);
+                last.length += text.length;
+            } else {
+                this.runs.push({ css : css, parts : [text], length : text.length });
+            }
+            this.pendingChars += text.length;
+
+            // タブが非表示で反映が止まっている間も溜まり続けないよう、未反映の出力にも上限を適用し、
+            // 古いメッセージから捨てる
+            while (this.pendingChars > this.maxChars && (this.runs.length > 1 || this.runs[0].parts.length > 1)) {
+                var oldest  = this.runs[0];
+                var dropped = oldest.parts.shift().length;
+                oldest.length     -= dropped;
+                this.pendingChars -= dropped;
+                if (oldest.parts.length === 0) this.runs.shift();
+            }
+
+            if (!this.scheduled) {
+                this.scheduled = true;
+                var self = this;
+                if (typeof requestAnimationFrame === 'function') {
+                    requestAnimationFrame(function() { self.flush(); });
+                } else {
+                    setTimeout(function() { self.flush(); }, 0);
+                }
+            }
+        },
+
+        flush : function() {
+            this.scheduled = false;
+            var output = document.getElementById('output');
+            var runs = this.runs;
+            this.runs = [];
+            this.pendingChars = 0;
+            if (!output || runs.length === 0) return;
+
+            var fragment = document.createDocumentFragment();
+            var index = 0;
+            // 直前に表示した出力と同じ色であれば、新しい span を作らずに末尾へ追記する
+            var tail = output.lastChild;
+            if (tail && tail.dataset && tail.dataset.css === runs[0].css && tail.firstChild) {
+                tail.firstChild.appendData(runs[0].parts.join(''));
+                this.shownChars += runs[0].length;
+                index = 1;
+            }
+            for (; index < runs.length; ++index) {
+                var span = document.createElement('span');
+                span.dataset.css = runs[index].css;
+                if (runs[index].css) span.style.color = runs[index].css;
+                span.textContent = runs[index].parts.join('');
+                fragment.appendChild(span);
+                this.shownChars += runs[index].length;
+            }
+            output.appendChild(fragment);
+            this.trim(output);
+        },
+
+        trim : function(output) {
+            // 上限を超えた分を古い順に削除する。span の途中で切る場合は行の区切りで切る
+            while (this.shownChars > this.maxChars && output.firstChild) {
+                var first  = output.firstChild;
+                var text   = first.textContent;
+                var excess = this.shownChars - this.maxChars;
+                var cut    = text.indexOf('\n', excess - 1) + 1;
+                if (cut === 0 || cut >= text.length || !first.firstChild) {
+                    output.removeChild(first);
+                    this.shownChars -= text.length;
+                } else {
+                    first.firstChild.deleteData(0, cut);
+                    this.shownChars -= cut;
+                }
+            }
+        }
+    };
 });
 
 
-// SweetAlert2 のダイアログが閉じられるまで C++ 側の実行を待機する。
-// EM_ASYNC_JS を使うことで Swal.fire() の Promise が解決するまでブロックする。
+// SweetAlert2 のダイアログを表示し、閉じられるのを待たずに戻る。
+// Promise を C++ 側に返さないため -sASYNCIFY は不要。
+// callbackId が 0 以外の場合は、ダイアログが閉じられた後に DebugPrintPopupClosed(callbackId) を呼び出す。
 // ブラウザ環境以外では stderr にフォールバックする
-EM_ASYNC_JS(void, js_show_popup, (const char* msg, const char* iconCStr, const char* detailCStr), {
+EM_JS(void, js_show_popup, (const char* msg, const char* iconCStr, const char* detailCStr, uint32_t callbackId), {
+    var notifyClosed = function() {
+        if (callbackId !== 0) _DebugPrintPopupClosed(callbackId);
+    };
+
     if (typeof window === 'undefined' || typeof Swal === 'undefined') {
         var text = UTF8ToString(msg) + UTF8ToString(detailCStr);
         process.stderr.write('[POPUP] ' + text);
+        Promise.resolve().then(notifyClosed);
         return;
     }
 
@@ -57,39 +175,145 @@ EM_ASYNC_JS(void, js_show_popup, (const char* msg, const char* iconCStr, const c
                  : 'メッセージ';
     var hasIcon = iconStr.length > 0;
 
-    // Swal.fire() の Promise を直接返すことで C++ 側がダイアログを閉じるまで待機する
-    return Swal.fire({
+    Swal.fire({
         title:             titleStr,
         html : UTF8ToString(msg) + UTF8ToString(detailCStr),
         icon : hasIcon ? iconStr : undefined,
         confirmButtonText : 'OK'
-    });
+    }).then(notifyClosed);
 });
 
 
 
+// メッセージ1件を直接表示する。通常の出力は WebOutputRing を通すため、
+// リングバッファに収まらない大きなメッセージのときだけ呼び出される
 EM_JS(void, js_print, (const char* msg, Color color), {
-    var text = UTF8ToString(msg);
-    var output = document.getElementById('output');
-    if (!output) { console.log(text); return; }
-    var span = document.createElement('span');
-    var cssColor = globalThis.makeColorCode(color);
-    if (cssColor) span.style.color = cssColor;
-    span.textContent = text;
-    output.appendChild(span);
-    });
+    globalThis.debugPrintWrite(UTF8ToString(msg), color, false);
+});
 
 
+// 標準エラー出力用のメッセージ1件を直接表示する。呼び出される条件は js_print と同じ
 EM_JS(void, js_print_error, (const char* msg, Color color), {
-    var text = UTF8ToString(msg);
-    var output = document.getElementById('output');
-    if (!output) { console.error(text); return; }
-    var span = document.createElement('span');
-    var cssColor = globalThis.makeColorCode(color);
-    if (cssColor) span.style.color = cssColor;
-    span.textContent = text;
-    output.appendChild(span);
-    });
+    globalThis.debugPrintWrite(UTF8ToString(msg), color, true);
+});
+
+
+// WebOutputRing のリングバッファの位置を登録し、取り出し処理を用意する。
+// header は [次に書き込む記録, 次に取り出す記録, 取り出し済みの文字列の位置, 予約済みフラグ] の uint32_t 配列、
+// records は1件あたり [開始位置, バイト数, UTF-16 の長さ, 色, 出力先, 文字列の終端] の uint32_t 配列。
+// 連続した文字列領域にあるメッセージはまとめて1回の TextDecoder でデコードし、長さで切り分ける
+EM_JS(void, js_register_output_ring, (uint32_t* header, uint32_t* records, uint32_t recordCapacity, uint8_t* text, uint32_t textCapacity), {
+    var decoder     = new TextDecoder('utf-8');
+    var headerIndex = header >> 2;
+    var recordIndex = records >> 2;
+
+    function decode(start, end) {
+        var bytes = HEAPU8.subarray(text + start, text + end);
+        // SharedArrayBuffer 上のビューは TextDecoder に渡せないため複製する
+        if (typeof SharedArrayBuffer !== 'undefined' && bytes.buffer instanceof SharedArrayBuffer) bytes = bytes.slice();
+        return decoder.decode(bytes);
+    }
+
+    function drain() {
+        HEAPU32[headerIndex + 3] = 0;
+        var read    = HEAPU32[headerIndex + 1];
+        var write   = HEAPU32[headerIndex];
+        var textEnd = HEAPU32[headerIndex + 2];
+        var batch   = [];
+        var spanStart = 0;
+        var spanEnd   = 0;
+        var spanUnits = 0;
+
+        function flushSpan() {
+            if (batch.length === 0) return;
+            var decoded  = decode(spanStart, spanEnd);
+            // 不正な UTF-8 が含まれて長さが合わない場合は1件ずつデコードする
+            var aligned  = decoded.length === spanUnits;
+            var position = 0;
+            for (var i = 0; i < batch.length; ++i) {
+                var entry = batch[i];
+                var message = aligned ? decoded.substring(position, position + entry.units)
+                                      : decode(entry.start, entry.start + entry.bytes);
+                position += entry.units;
+                globalThis.debugPrintWrite(message, entry.color, entry.isError);
+            }
+            batch = [];
+        }
+
+        for (var seq = read; seq !== write; seq = (seq + 1) >>> 0) {
+            var base  = recordIndex + (seq % recordCapacity) * 6;
+            var start = HEAPU32[base];
+            var bytes = HEAPU32[base + 1];
+            var units = HEAPU32[base + 2];
+            if (batch.length > 0 && start !== spanEnd) flushSpan();
+            if (batch.length === 0) {
+                spanStart = start;
+                spanEnd   = start;
+                spanUnits = 0;
+            }
+            batch.push({ start : start, bytes : bytes, units : units, color : HEAPU32[base + 3], isError : HEAPU32[base + 4] !== 0 });
+            spanEnd   += bytes;
+            spanUnits += units;
+            textEnd    = HEAPU32[base + 5];
+        }
+        flushSpan();
+        HEAPU32[headerIndex + 1] = write;
+        HEAPU32[headerIndex + 2] = textEnd;
+    }
+
+    globalThis.debugPrintRing = {
+        drain : drain,
+        schedule : function() {
+            if (typeof requestAnimationFrame === 'function') {
+                requestAnimationFrame(drain);
+            } else {
+                setTimeout(drain, 0);
+            }
+        }
+    };
+
+    // Node.js で終了するときに、まだ取り出していない出力を書き出す
+    if (typeof process !== 'undefined' && typeof process.on === 'function') process.on('exit', drain);
+});
+
+
+// リングバッファの取り出しを次の描画フレーム(Node.js では次のタイマー)に予約する。
+// 空のリングバッファに最初のメッセージを書き込んだときだけ呼び出される
+EM_JS(void, js_output_ring_schedule, (), {
+    globalThis.debugPrintRing.schedule();
+});
+
+
+// リングバッファに溜まっているメッセージをその場ですべて取り出して表示する
+EM_JS(void, js_output_ring_drain, (), {
+    globalThis.debugPrintRing.drain();
+});
+
+
+// PRINT_TRACE_FUNCTION のスコープを User Timing の measure として記録する。
+// 開始時刻は C++ 側で performance.now() と同じ時間軸で計測済みのため、開始時の mark は作らずに終了時に1回だけ呼び出す。
+// 関数名とファイル名は呼び出し箇所の文字列リテラルのため、アドレスごとにデコード結果を使い回す
+EM_JS(void, js_performance_measure, (const char* name, const char* file, int line, double startMs, double durationMs), {
+    if (typeof performance === 'undefined' || typeof performance.measure !== 'function') return;
+    var names = globalThis.debugPrintMeasureNames || (globalThis.debugPrintMeasureNames = new Map());
+    var decode = function(ptr) {
+        var text = names.get(ptr);
+        if (text === undefined) {
+            text = UTF8ToString(ptr);
+            names.set(ptr, text);
+        }
+        return text;
+    };
+    try {
+        performance.measure(decode(name), {
+            start    : startMs,
+            duration : durationMs,
+            detail   : { file : decode(file), line : line }
+        });
+    } catch (e) {
+        // User Timing Level 3 に対応していない環境では記録しない
+    }
+});
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace DebugPrint
+{
+    /// @brief PRINT_TRACE_FUNCTION のスコープの入れ子から折り畳みスタック形式
+    /// ("main;update;physics 1234")のフレームグラフ用データを集計するシングルトンクラス。
+    /// スレッドごとにスコープのスタックを持ち、スコープ終了時に子スコープの時間を除いた
+    /// 排他時間をスタックの経路ごとに加算する。
+    /// 出力の重みはマイクロ秒で、flamegraph.pl などの一般的なツールにそのまま渡せる
+    class FlameGraphCollector
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static FlameGraphCollector& GetInstance()
+        {
+            static FlameGraphCollector instance;
+            return instance;
+        }
+
+        /// @brief 現在のスレッドのスタックにスコープを積む
+        /// @param name スコープ名(関数名)
+        void PushScope(const char* name)
+        {
+            auto& stack = GetThreadStack();
+
+            std::string path;
+            if (!stack.empty())
+            {
+                path = stack.back().path + ";";
+            }
+            AppendFrameName(path, name);
+            stack.push_back({ std::move(path), 0 });
+        }
+
+        /// @brief 現在のスレッドのスタックからスコープを降ろし、排他時間を加算する
+        /// @param elapsedNanoseconds スコープの経過時間(ナノ秒)
+        void PopScope(uint64_t elapsedNanoseconds)
+        {
+            auto& stack = GetThreadStack();
+            if (stack.empty()) return;
+
+            Frame frame = std::move(stack.back());
+            stack.pop_back();
+
+            // 子スコープの時間を差し引いた排他時間を求め、親には包含時間を子の時間として渡す
+            const uint64_t exclusive = elapsedNanoseconds > frame.childNanoseconds
+                ? elapsedNanoseconds - frame.childNanoseconds : 0;
+            if (!stack.empty())
+            {
+                stack.back().childNanoseconds += elapsedNanoseconds;
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_FoldedStacks[frame.path] += exclusive;
+        }
+
+        /// @brief 集計結果を折り畳みスタック形式の文字列で取得する。
+        /// 重みがマイクロ秒単位で0になる経路は出力しない
+        /// @return 1行に1経路の折り畳みスタック文字列
+        [[nodiscard]] std::string GetFoldedString() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            std::ostringstream out;
+            for (const auto& [path, nanoseconds] : m_FoldedStacks)
+            {
+                const uint64_t microseconds = nanoseconds / 1000;
+                if (microseconds == 0) continue;
+                out << path << " " << microseconds << "\n";
+            }
+            return out.str();
+        }
+
+        /// @brief 集計結果を折り畳みスタック形式でファイルに書き出す。
+        /// 出力先ディレクトリが存在しない場合は自動的に作成する
+        /// @param filePath 出力先ファイルパス ("./logs/trace.folded" など)
+        /// @return 書き出しに成功した場合は true、失敗した場合は false
+        bool WriteToFile(const std::string& filePath) const
+        {
+            const std::filesystem::path dirPath = std::filesystem::path(filePath).parent_path();
+            if (!dirPath.empty() && !std::filesystem::exists(dirPath))
+            {
+                std::filesystem::create_directories(dirPath);
+            }
+
+            std::ofstream file(filePath, std::ios::out | std::ios::trunc);
+            if (!file.is_open())
+            {
+                return false;
+            }
+            file << GetFoldedString();
+            return true;
+        }
+
+        /// @brief 集計結果をすべて消去する
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_FoldedStacks.clear();
+        }
+
+        // コピー・ムーブ禁止
+        FlameGraphCollector(const FlameGraphCollector&) = delete;
+        FlameGraphCollector& operator=(const FlameGraphCollector&) = delete;
+        FlameGraphCollector(FlameGraphCollector&&) = delete;
+        FlameGraphCollector& operator=(FlameGraphCollector&&) = delete;
+
+    private:
+
+        /// @brief スタック上のスコープ1つ分の情報
+        struct Frame
+        {
+            std::string path;              // ルートからこのスコープまでの経路
+            uint64_t    childNanoseconds;  // 子スコープの包含時間の合計
+        };
+
+        FlameGraphCollector() = default;
+
+        /// @brief 現在のスレッドのスコープスタックを取得する
+        static std::vector<Frame>& GetThreadStack()
+        {
+            thread_local std::vector<Frame> stack;
+            return stack;
+        }
+
+        /// @brief 経路にフレーム名を追加する。
+        /// 区切り文字の ';' と改行は折り畳みスタック形式を壊すため置き換える
+        static void AppendFrameName(std::string& path, const char* name)
+        {
+            for (const char* c = name; *c != '\0'; ++c)
+            {
+                path += (*c == ';' || *c == '\n') ? ':' : *c;
+            }
+        }
+
+        mutable std::mutex m_Mutex;  // m_FoldedStacks の排他制御用
+        std::map<std::string, uint64_t> m_FoldedStacks;  // 経路ごとの排他時間の合計(ナノ秒)
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
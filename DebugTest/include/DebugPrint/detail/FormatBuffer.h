@@ -0,0 +1,140 @@
+#pragma once
+#include <charconv>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace DebugPrint
+{
+    /// @brief to_chars で直接書き出せる数値型かどうかを判定する。
+    /// bool と文字型は << 演算子と表示が異なるため除外する
+    template <typename T>
+    inline constexpr bool is_to_chars_formattable =
+        std::is_arithmetic_v<T> &&
+        !std::is_same_v<T, bool> &&
+        !std::is_same_v<T, char> &&
+        !std::is_same_v<T, signed char> &&
+        !std::is_same_v<T, unsigned char> &&
+        !std::is_same_v<T, wchar_t> &&
+        !std::is_same_v<T, char8_t> &&
+        !std::is_same_v<T, char16_t> &&
+        !std::is_same_v<T, char32_t>;
+
+    /// @brief スレッドごとに1つを使い回すオブジェクト。
+    /// 静的オブジェクトのデストラクタ(終了時の集計表示など)は、メインスレッドの thread_local が破棄された後に実行される。
+    /// 破棄後に参照すると解放済みの領域を使うため、破棄済みかどうかをデストラクタを持たないフラグで記録し、
+    /// 破棄後は nullptr を返して呼び出し側に一時オブジェクトを使わせる
+    template <typename T>
+    class ThreadReusable
+    {
+    public:
+        /// @brief 現在のスレッドのオブジェクトを取得する
+        /// @return スレッドのオブジェクト。スレッドの終了処理で破棄済みの場合は nullptr
+        [[nodiscard]] static T* Get()
+        {
+            if (t_Destroyed) return nullptr;
+            thread_local Holder holder;
+            return &holder.value;
+        }
+
+    private:
+        /// @brief 破棄時にフラグを立てるための入れ物
+        struct Holder
+        {
+            T value;
+            ~Holder() { t_Destroyed = true; }
+        };
+
+        static inline thread_local bool t_Destroyed = false;  // 破棄済みかどうか(デストラクタを持たないため終了処理中も参照できる)
+    };
+
+    /// @brief 値を文字列バッファの末尾に追加する。
+    /// 数値型は to_chars で直接書き込み、それ以外は使い回しの ostringstream で << 演算子を使う。
+    /// 浮動小数点数は << 演算子の既定と同じく有効桁数6桁の general 形式で出力する
+    /// @param out 追加先のバッファ
+    /// @param value 追加する値
+    template <typename T>
+    void AppendValue(std::string& out, const T& value)
+    {
+        if constexpr (is_to_chars_formattable<T>)
+        {
+            char buffer[64];
+            std::to_chars_result result;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+            }
+            else
+            {
+                result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            }
+            out.append(buffer, result.ptr);
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            out += value ? '1' : '0';
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            out += std::string_view(value);
+        }
+        else
+        {
+            // ストリームは生成コストが高いため、スレッドごとに1つを使い回す
+            std::ostringstream* shared = ThreadReusable<std::ostringstream>::Get();
+            if (shared == nullptr)
+            {
+                std::ostringstream stream;
+                stream << value;
+                out += stream.view();
+                return;
+            }
+            shared->str(std::string());
+            shared->clear();
+            *shared << value;
+            out += shared->view();
+        }
+    }
+
+    /// @brief 出力文字列を組み立てるためのスレッドごとの再利用バッファ。
+    /// 生成時にスレッドの共有バッファを借り受け、破棄時に容量を残したまま返却する。
+    /// 描画中に同じスレッドで再度借り受けられた場合は新しいバッファを使うため、
+    /// 入れ子で使用しても内容が壊れない。
+    /// 終了時の静的オブジェクトのデストラクタなど、共有バッファが破棄された後は借り受けずに新しいバッファを使う
+    class ScopedFormatBuffer
+    {
+    public:
+        /// @brief スレッドの共有バッファを借り受ける
+        ScopedFormatBuffer()
+        {
+            if (std::string* shared = ThreadReusable<std::string>::Get())
+            {
+                m_Buffer = std::move(*shared);
+                m_Buffer.clear();
+            }
+        }
+
+        /// @brief バッファを容量を残したまま返却する
+        ~ScopedFormatBuffer()
+        {
+            std::string* shared = ThreadReusable<std::string>::Get();
+            if (shared != nullptr && shared->capacity() < m_Buffer.capacity())
+            {
+                *shared = std::move(m_Buffer);
+            }
+        }
+
+        ScopedFormatBuffer(const ScopedFormatBuffer&) = delete;
+        ScopedFormatBuffer& operator=(const ScopedFormatBuffer&) = delete;
+
+        /// @brief 借り受けたバッファを取得する
+        [[nodiscard]] std::string& Get() { return m_Buffer; }
+
+    private:
+        std::string m_Buffer;  // 借り受けたバッファ
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
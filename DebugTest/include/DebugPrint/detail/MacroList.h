@@ -26,3 +26,23 @@
 #define THIS_FUNCTION_NAME __func__
 #endif
 
+// 空のメンバ変数にアドレスを割り当てずクラスサイズを増やさないための属性。
+// MSVC は標準の [[no_unique_address]] を無視するため専用の属性を使う
+#if defined(_MSC_VER)
+#define DEBUG_PRINT_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define DEBUG_PRINT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// 関数をインライン展開しないための属性
+#if defined(_MSC_VER)
+#define DEBUG_PRINT_NOINLINE __declspec(noinline)
+#else
+#define DEBUG_PRINT_NOINLINE __attribute__((noinline))
+#endif
+
+// std::thread を使えるかどうか。Emscripten では -pthread でビルドした場合のみ使える
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define DEBUG_PRINT_HAS_THREADS
+#endif
+
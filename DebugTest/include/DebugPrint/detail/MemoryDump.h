@@ -0,0 +1,261 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#define DEBUG_PRINT_HAS_SSSE3
+#endif
+
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "DebugPrintConfig.h"
+#include "FormatBuffer.h"
+#include "NumericFormat.h"
+
+namespace DebugPrint
+{
+    // ダンプ1行に表示するバイト数
+    inline constexpr std::size_t MEMORY_DUMP_BYTES_PER_LINE = 16;
+
+    // ダンプ1行の最大文字数("オフセット16桁  16進数  |ASCII|\n")
+    inline constexpr std::size_t MEMORY_DUMP_LINE_CAPACITY = 16 + 2 + MEMORY_DUMP_BYTES_PER_LINE * 3 + 1 + 1 + MEMORY_DUMP_BYTES_PER_LINE + 2;
+
+    // 一括書き出しで一度に領域を確保する行数
+    inline constexpr std::size_t MEMORY_DUMP_BLOCK_LINES = 4096;
+
+    // 小文字の16進数字
+    inline constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+    // 00 ～ ff の2桁の16進数を並べた表
+    inline constexpr std::array<char, 512> HEX_PAIRS = []
+    {
+        std::array<char, 512> table{};
+        for (int i = 0; i < 256; ++i)
+        {
+            table[i * 2]     = HEX_DIGITS[i >> 4];
+            table[i * 2 + 1] = HEX_DIGITS[i & 0xF];
+        }
+        return table;
+    }();
+
+    /// @brief オフセットを指定桁数の16進数で書き出す
+    /// @param dest 書き出し先
+    /// @param offset 書き出す値
+    /// @param digits 桁数
+    /// @return 書き出した末尾の次の位置
+    inline char* WriteHexOffset(char* dest, uint64_t offset, int digits) noexcept
+    {
+        for (int i = digits - 1; i >= 0; --i)
+        {
+            dest[i] = HEX_DIGITS[offset & 0xF];
+            offset >>= 4;
+        }
+        return dest + digits;
+    }
+
+    /// @brief 16バイトを "xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|" の形式で書き出す。
+    /// SSSE3 が使える場合は pshufb で4ビットずつ16進数字に変換し、区切りの空白の挿入と
+    /// 表示できない文字の '.' への置き換えもベクトル演算で行う
+    /// @param dest 書き出し先(MEMORY_DUMP_LINE_CAPACITY 以上の空きが必要)
+    /// @param bytes 16バイトの先頭
+    /// @return 書き出した末尾の次の位置
+    inline char* WriteHexLine16(char* dest, const uint8_t* bytes) noexcept
+    {
+#if defined(DEBUG_PRINT_HAS_SSSE3)
+        const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+        const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+        const __m128i low  = _mm_shuffle_epi8(digits, _mm_and_si128(input, nibble));
+
+        // 1バイトにつき2桁の16進数を並べ、3文字ごとに空白を挟む(0x80 の位置は0になり、空白で埋める)
+        const __m128i pairs[2] = { _mm_unpacklo_epi8(high, low), _mm_unpackhi_epi8(high, low) };
+        const __m128i spreadFirst = _mm_setr_epi8(0, 1, -128, 2, 3, -128, 4, 5, -128, 6, 7, -128, 8, 9, -128, 10);
+        const __m128i spreadRest  = _mm_setr_epi8(11, -128, 12, 13, -128, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+        const __m128i spacesFirst = _mm_setr_epi8(0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0, 0, ' ', 0);
+        const __m128i spacesRest  = _mm_setr_epi8(0, ' ', 0, 0, ' ', 0, 0, ' ', ' ', 0, 0, 0, 0, 0, 0, 0);
+
+        char* p = dest;
+        for (const __m128i& pair : pairs)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_or_si128(_mm_shuffle_epi8(pair, spreadFirst), spacesFirst));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16), _mm_or_si128(_mm_shuffle_epi8(pair, spreadRest), spacesRest));
+            p += 25;  // 8バイト分の "xx " と区切りの空白1つ
+        }
+
+        // 0x20 ～ 0x7e 以外は '.' にする(0x80 以上は符号付き比較で負になるため除外される)
+        const __m128i printable = _mm_and_si128(
+            _mm_cmpgt_epi8(input, _mm_set1_epi8(0x1F)),
+            _mm_cmplt_epi8(input, _mm_set1_epi8(0x7F)));
+        const __m128i ascii = _mm_or_si128(
+            _mm_and_si128(printable, input),
+            _mm_andnot_si128(printable, _mm_set1_epi8('.')));
+        *p++ = '|';
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), ascii);
+        p += 16;
+        *p++ = '|';
+        return p;
+#else
+        char* p = dest;
+        for (std::size_t i = 0; i < MEMORY_DUMP_BYTES_PER_LINE; ++i)
+        {
+            std::memcpy(p, HEX_PAIRS.data() + bytes[i] * 2, 2);
+            p[2] = ' ';
+            p += 3;
+            if (i == 7) *p++ = ' ';
+        }
+        *p++ = ' ';
+        *p++ = '|';
+        for (std::size_t i = 0; i < MEMORY_DUMP_BYTES_PER_LINE; ++i)
+        {
+            *p++ = (bytes[i] >= 0x20 && bytes[i] < 0x7F) ? static_cast<char>(bytes[i]) : '.';
+        }
+        *p++ = '|';
+        return p;
+#endif
+    }
+
+    /// @brief 16バイトに満たない最終行を書き出す。16進数の欄は空白で埋めて ASCII の欄の位置を揃える
+    /// @param dest 書き出し先
+    /// @param bytes 先頭
+    /// @param count バイト数(16未満)
+    /// @return 書き出した末尾の次の位置
+    inline char* WriteHexLinePartial(char* dest, const uint8_t* bytes, std::size_t count) noexcept
+    {
+        char* p = dest;
+        for (std::size_t i = 0; i < MEMORY_DUMP_BYTES_PER_LINE; ++i)
+        {
+            if (i < count)
+            {
+                std::memcpy(p, HEX_PAIRS.data() + bytes[i] * 2, 2);
+            }
+            else
+            {
+                p[0] = ' ';
+                p[1] = ' ';
+            }
+            p[2] = ' ';
+            p += 3;
+            if (i == 7) *p++ = ' ';
+        }
+        *p++ = ' ';
+        *p++ = '|';
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            *p++ = (bytes[i] >= 0x20 && bytes[i] < 0x7F) ? static_cast<char>(bytes[i]) : '.';
+        }
+        *p++ = '|';
+        return p;
+    }
+
+    /// @brief メモリの内容を "オフセット  16進数  |ASCII|" の形式(hexdump -C と同じ)でバッファに追加する。
+    /// 直前の行と同じ内容が続く行は、省略が有効な場合 "*" の1行にまとめる。
+    /// 最後に末尾のオフセットを1行で表示する。hexdump と同じく、0バイトの場合は何も追加しない
+    /// @param out 追加先のバッファ
+    /// @param data 先頭アドレス
+    /// @param size 表示するバイト数
+    /// @param collapse 同じ内容の行を省略するかどうか
+    inline void AppendHexDump(std::string& out, const uint8_t* data, std::size_t size, bool collapse)
+    {
+        if (size == 0) return;
+
+        // オフセットは8桁で、収まらない大きさの場合のみ16桁にする
+        const int offsetDigits = size > 0xFFFFFFFFull ? 16 : 8;
+        const std::size_t lineCount = (size + MEMORY_DUMP_BYTES_PER_LINE - 1) / MEMORY_DUMP_BYTES_PER_LINE;
+
+        // ブロックごとの拡張で再確保と複写が繰り返されないよう、最大サイズを先に確保する
+        out.reserve(out.size() + lineCount * MEMORY_DUMP_LINE_CAPACITY + MEMORY_DUMP_LINE_CAPACITY);
+
+        bool skipping = false;
+        for (std::size_t blockStart = 0; blockStart < lineCount; blockStart += MEMORY_DUMP_BLOCK_LINES)
+        {
+            const std::size_t blockEnd = (blockStart + MEMORY_DUMP_BLOCK_LINES < lineCount) ? blockStart + MEMORY_DUMP_BLOCK_LINES : lineCount;
+            const std::size_t start = out.size();
+            out.resize(start + MEMORY_DUMP_LINE_CAPACITY * (blockEnd - blockStart));
+
+            char* p = out.data() + start;
+            for (std::size_t line = blockStart; line < blockEnd; ++line)
+            {
+                const std::size_t offset = line * MEMORY_DUMP_BYTES_PER_LINE;
+                const std::size_t count = (size - offset < MEMORY_DUMP_BYTES_PER_LINE) ? size - offset : MEMORY_DUMP_BYTES_PER_LINE;
+
+                if (collapse && line > 0 && count == MEMORY_DUMP_BYTES_PER_LINE &&
+                    std::memcmp(data + offset, data + offset - MEMORY_DUMP_BYTES_PER_LINE, MEMORY_DUMP_BYTES_PER_LINE) == 0)
+                {
+                    if (!skipping)
+                    {
+                        *p++ = '*';
+                        *p++ = '\n';
+                        skipping = true;
+                    }
+                    continue;
+                }
+                skipping = false;
+
+                p = WriteHexOffset(p, offset, offsetDigits);
+                *p++ = ' ';
+                *p++ = ' ';
+                p = (count == MEMORY_DUMP_BYTES_PER_LINE)
+                    ? WriteHexLine16(p, data + offset)
+                    : WriteHexLinePartial(p, data + offset, count);
+                *p++ = '\n';
+            }
+            out.resize(static_cast<std::size_t>(p - out.data()));
+        }
+
+        char offset[16];
+        out.append(offset, WriteHexOffset(offset, size, offsetDigits));
+        out += '\n';
+    }
+
+    /// @brief メモリの内容を16進数と ASCII でコンソールに表示する。
+    /// 表示するバイト数が上限を超える場合は先頭のみを表示し、残りのバイト数を表示する。
+    /// 0バイトの場合は何も表示しない。
+    /// PRINT_MEMORY マクロから呼び出される
+    /// @param name 表示するアドレスの式の文字列
+    /// @param address 先頭アドレス
+    /// @param size バイト数
+    /// @param color 表示色
+    inline void PrintMemory(const char* name, const void* address, std::size_t size, Color color = PRINT_COLOR::DEFAULT)
+    {
+        if (size == 0) return;
+
+        const DebugPrintConfig& config = DebugPrintConfig::GetInstance();
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+
+        out += memoryString();
+        out += pairSeparatorString();
+        out += name;
+        out += "  ";
+        out += byteSizeString();
+        out += pairSeparatorString();
+        AppendValue(out, size);
+        out += '\n';
+
+        if (address == nullptr)
+        {
+            out += "nullptr\n";
+            PrintMessage(out, color);
+            return;
+        }
+
+        const std::size_t maxBytes = config.GetMemoryDumpMaxBytes();
+        const std::size_t shown = size > maxBytes ? maxBytes : size;
+        AppendHexDump(out, static_cast<const uint8_t*>(address), shown, config.IsMemoryDumpCollapseEnabled());
+        if (shown < size)
+        {
+            out += omittedBytesString();
+            out += pairSeparatorString();
+            AppendValue(out, size - shown);
+            out += '\n';
+        }
+
+        PrintMessage(out, color);
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
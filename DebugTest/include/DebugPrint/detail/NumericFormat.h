@@ -0,0 +1,416 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "FormatBuffer.h"
+
+namespace DebugPrint
+{
+    /// @brief 要素が数値型で、メモリ上に連続して並んだ範囲かどうかを判定する。
+    /// std::vector<float>・std::array<int, N>・C配列などが該当し、一括書式化の対象になる
+    template <typename T>
+    concept NumericContiguousRange =
+        std::ranges::contiguous_range<const T> &&
+        std::ranges::sized_range<const T> &&
+        is_to_chars_formattable<std::remove_cvref_t<std::ranges::range_value_t<const T>>>;
+
+    // 00 ～ 99 の2桁の数字を並べた表。整数を2桁ずつまとめて変換するために使う
+    inline constexpr std::array<char, 200> DIGIT_PAIRS = []
+    {
+        std::array<char, 200> table{};
+        for (int i = 0; i < 100; ++i)
+        {
+            table[i * 2]     = static_cast<char>('0' + i / 10);
+            table[i * 2 + 1] = static_cast<char>('0' + i % 10);
+        }
+        return table;
+    }();
+
+    // 数値1つを書き出すのに必要な最大文字数(64ビット整数の符号付き20桁・有効桁数6桁の浮動小数点数を収める)
+    inline constexpr std::size_t MAX_NUMBER_CHARS = 24;
+
+    // 10^0 ～ 10^19。整数の桁数を求めるために使う
+    inline constexpr std::array<uint64_t, 20> POW10_U64 = []
+    {
+        std::array<uint64_t, 20> table{};
+        uint64_t value = 1;
+        for (uint64_t& entry : table)
+        {
+            entry = value;
+            value *= 10;
+        }
+        return table;
+    }();
+
+    /// @brief 型 T の値1つを WriteNumber で書き出したときの最大文字数を求める。
+    /// 一括書き出しで確保する領域を実際の出力に近い大きさにするために使う
+    template <typename T>
+    [[nodiscard]] constexpr std::size_t MaxNumberChars() noexcept
+    {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            return 13;  // "-1.23457e-308"
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return MAX_NUMBER_CHARS;
+        }
+        else
+        {
+            // 符号と、digits10 に含まれない最上位の桁
+            return static_cast<std::size_t>(std::numeric_limits<T>::digits10) + 2;
+        }
+    }
+
+    /// @brief 符号なし整数を10進数で書き出す。
+    /// 下位から2桁ずつ表引きで変換し、除算とループの回数を半分にする。
+    /// 32ビット以下の値は32ビットのまま計算させるため、値の型をテンプレート引数で受け取る
+    /// @param dest 書き出し先(MAX_NUMBER_CHARS 以上の空きが必要)
+    /// @param value 書き出す値
+    /// @return 書き出した末尾の次の位置
+    template <typename Unsigned>
+    char* WriteUnsignedDecimal(char* dest, Unsigned value) noexcept
+    {
+        // 先に桁数を求めて書き出し先へ直接並べる(可変長の memcpy は短い文字列では関数呼び出しが重い)
+        // 2進の桁数から10進の桁数を見積もり(1233 / 2^12 ≒ log10(2))、10の累乗と1回比べて補正する
+        const uint64_t nonZero = static_cast<uint64_t>(value) | 1;
+        const std::size_t estimate = static_cast<std::size_t>((std::bit_width(nonZero) * 1233) >> 12);
+        const std::size_t digitCount = estimate + (nonZero >= POW10_U64[estimate] ? 1 : 0);
+        char* const end = dest + digitCount;
+        char* p = end;
+        while (value >= 100)
+        {
+            const std::size_t pair = static_cast<std::size_t>(value % 100) * 2;
+            value /= 100;
+            p -= 2;
+            std::memcpy(p, DIGIT_PAIRS.data() + pair, 2);
+        }
+        if (value >= 10)
+        {
+            p -= 2;
+            std::memcpy(p, DIGIT_PAIRS.data() + value * 2, 2);
+        }
+        else
+        {
+            *--p = static_cast<char>('0' + value);
+        }
+        return end;
+    }
+
+    // 10^0 ～ 10^22。倍精度浮動小数点数で誤差なく表せる10の累乗
+    inline constexpr std::array<double, 23> POW10_TABLE =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /// @brief 浮動小数点数を printf の "%g" (有効桁数6桁) と同じ形式で書き出す。
+    /// 値を 10^5 ～ 10^6 の範囲に拡大縮小して6桁の整数に丸め、表引きで数字にする。
+    /// 拡大縮小の誤差は 1e-9 程度のため、丸めの境界(端数が 0.5)に近い値や
+    /// 範囲外・非正規化数・無限大・NaN は std::to_chars に任せて結果を厳密に一致させる
+    /// @param dest 書き出し先(MAX_NUMBER_CHARS 以上の空きが必要)
+    /// @param value 書き出す値
+    /// @return 書き出した末尾の次の位置
+    template <typename T>
+    char* WriteFloatGeneral(char* dest, T value) noexcept
+    {
+        auto fallback = [&] { return std::to_chars(dest, dest + MAX_NUMBER_CHARS, value, std::chars_format::general, 6).ptr; };
+
+        const double signedValue = static_cast<double>(value);
+        const double magnitude = signedValue < 0 ? -signedValue : signedValue;
+        if (!(magnitude >= 1e-30 && magnitude < 1e30))
+        {
+            return fallback();
+        }
+
+        // 2進指数から10進指数を見積もる(78913 / 2^18 ≒ log10(2))
+        uint64_t bits;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        const int binaryExponent = static_cast<int>((bits >> 52) & 0x7FF) - 1023;
+        int exponent = (binaryExponent * 78913) >> 18;
+
+        auto scale = [magnitude](int exp10)
+        {
+            const int k = 5 - exp10;
+            if (k >= 0)
+            {
+                return k <= 22 ? magnitude * POW10_TABLE[k] : magnitude * POW10_TABLE[22] * POW10_TABLE[k - 22];
+            }
+            return -k <= 22 ? magnitude / POW10_TABLE[-k] : magnitude / POW10_TABLE[22] / POW10_TABLE[-k - 22];
+        };
+
+        double scaled = scale(exponent);
+        if (scaled >= 1e6)     scaled = scale(++exponent);
+        else if (scaled < 1e5) scaled = scale(--exponent);
+
+        const double integral = static_cast<double>(static_cast<int64_t>(scaled));
+        const double fraction = scaled - integral;
+        if (scaled < 1e5 || scaled >= 1e6 || (fraction > 0.5 - 1e-6 && fraction < 0.5 + 1e-6))
+        {
+            return fallback();
+        }
+
+        uint32_t digits = static_cast<uint32_t>(integral) + (fraction > 0.5 ? 1 : 0);
+        if (digits == 1000000)
+        {
+            digits = 100000;
+            ++exponent;
+        }
+
+        // 固定長でまとめて書き込むときに6桁の先まで読むため、余分に確保しておく
+        char digitChars[16] = {};
+        std::memcpy(digitChars,     DIGIT_PAIRS.data() + (digits / 10000) * 2, 2);
+        std::memcpy(digitChars + 2, DIGIT_PAIRS.data() + (digits / 100 % 100) * 2, 2);
+        std::memcpy(digitChars + 4, DIGIT_PAIRS.data() + (digits % 100) * 2, 2);
+
+        // "%g" と同じく末尾の0を取り除く
+        int length = 6;
+        while (length > 1 && digitChars[length - 1] == '0') --length;
+
+        // 以下では桁の並びを固定長でまとめて書き込み、実際の長さだけ位置を進める。
+        // 書き込むのは最大13文字のため MAX_NUMBER_CHARS に収まる
+        char* p = dest;
+        if (signedValue < 0) *p++ = '-';
+
+        if (exponent >= -4 && exponent < 6)
+        {
+            // 固定小数点表記
+            if (exponent >= 0)
+            {
+                // 整数部は6桁の並びの先頭をそのまま使う(末尾の0も含めて正しい)
+                const int integerDigits = exponent + 1;
+                std::memcpy(p, digitChars, 6);
+                p[integerDigits] = '.';
+                std::memcpy(p + integerDigits + 1, digitChars + integerDigits, 6 - 1);
+                p += length > integerDigits ? length + 1 : integerDigits;
+            }
+            else
+            {
+                const int leadingZeros = -exponent - 1;
+                std::memcpy(p, "0.000", 5);
+                std::memcpy(p + 2 + leadingZeros, digitChars, 6);
+                p += 2 + leadingZeros + length;
+            }
+        }
+        else
+        {
+            // 指数表記(指数は2桁以上)
+            p[0] = digitChars[0];
+            p[1] = '.';
+            std::memcpy(p + 2, digitChars + 1, 6 - 1);
+            p += length > 1 ? length + 1 : 1;
+            *p++ = 'e';
+            *p++ = exponent < 0 ? '-' : '+';
+            const int absExponent = exponent < 0 ? -exponent : exponent;
+            std::memcpy(p, DIGIT_PAIRS.data() + absExponent * 2, 2);
+            p += 2;
+        }
+        return p;
+    }
+
+    /// @brief 数値を書き出す。
+    /// 整数は表引きで、浮動小数点数は << 演算子の既定と同じ有効桁数6桁の general 形式で変換する
+    /// @param dest 書き出し先(MAX_NUMBER_CHARS 以上の空きが必要)
+    /// @param value 書き出す値
+    /// @return 書き出した末尾の次の位置
+    template <typename T>
+    char* WriteNumber(char* dest, T value) noexcept
+    {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            return WriteFloatGeneral(dest, value);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return std::to_chars(dest, dest + MAX_NUMBER_CHARS, value, std::chars_format::general, 6).ptr;
+        }
+        else
+        {
+            using Unsigned = std::conditional_t<(sizeof(T) <= sizeof(uint32_t)), uint32_t, uint64_t>;
+            Unsigned magnitude = static_cast<Unsigned>(value);
+            if constexpr (std::is_signed_v<T>)
+            {
+                if (value < 0)
+                {
+                    *dest++ = '-';
+                    magnitude = 0 - magnitude;
+                }
+            }
+            return WriteUnsignedDecimal(dest, magnitude);
+        }
+    }
+
+    // 行頭の文字列をまとめて書き込む単位のバイト数。
+    // 短い可変長の memcpy は関数呼び出しになるため、固定長の塊で書き込んで書き出し先の余白で溢れを受ける
+    inline constexpr std::size_t LINE_PREFIX_CHUNK = 16;
+
+    /// @brief 一括書き出しの各行の先頭に置く "[添字]: " の文字列。
+    /// 連続した要素の添字は1ずつ増えるため、毎回整数から変換せずに文字列の中の数字をそのまま繰り上げる
+    class NumericLinePrefix
+    {
+    public:
+
+        /// @brief コンストラクタ
+        /// @param open 添字の前に置く文字列
+        /// @param firstIndex 最初の添字
+        /// @param maxIndexDigits 添字の最大桁数
+        /// @param closeSeparator 添字と値の間に置く文字列
+        NumericLinePrefix(std::string_view open, std::size_t firstIndex, std::size_t maxIndexDigits, std::string_view closeSeparator)
+            : m_CloseSeparator(closeSeparator)
+        {
+            const std::size_t capacity = open.size() + maxIndexDigits + closeSeparator.size();
+            m_Chars.resize((capacity + LINE_PREFIX_CHUNK - 1) / LINE_PREFIX_CHUNK * LINE_PREFIX_CHUNK);
+            std::memcpy(m_Chars.data(), open.data(), open.size());
+            m_DigitsBegin = open.size();
+            m_DigitsEnd = static_cast<std::size_t>(WriteUnsignedDecimal(m_Chars.data() + m_DigitsBegin, static_cast<uint64_t>(firstIndex)) - m_Chars.data());
+            std::memcpy(m_Chars.data() + m_DigitsEnd, closeSeparator.data(), closeSeparator.size());
+            m_Length = m_DigitsEnd + closeSeparator.size();
+        }
+
+        /// @brief 現在の文字列を書き出す。
+        /// 末尾の余白まで LINE_PREFIX_CHUNK 単位で書き込むため、書き出し先には文字列の長さに加えて LINE_PREFIX_CHUNK 以上の空きが必要
+        /// @return 書き出した末尾の次の位置
+        char* Write(char* dest) const noexcept
+        {
+            for (std::size_t i = 0; i < m_Length; i += LINE_PREFIX_CHUNK)
+            {
+                std::memcpy(dest + i, m_Chars.data() + i, LINE_PREFIX_CHUNK);
+            }
+            return dest + m_Length;
+        }
+
+        /// @brief 添字を1増やす。桁が増える場合は後ろの文字列をずらす
+        void Increment() noexcept
+        {
+            char* const begin = m_Chars.data() + m_DigitsBegin;
+            char* p = m_Chars.data() + m_DigitsEnd;
+            while (p != begin)
+            {
+                if (*--p != '9')
+                {
+                    ++*p;
+                    return;
+                }
+                *p = '0';
+            }
+            *begin = '1';
+            m_Chars[m_DigitsEnd++] = '0';
+            std::memcpy(m_Chars.data() + m_DigitsEnd, m_CloseSeparator.data(), m_CloseSeparator.size());
+            ++m_Length;
+        }
+
+    private:
+        std::string      m_Chars;           // 文字列(LINE_PREFIX_CHUNK の倍数の長さに切り上げて確保する)
+        std::string_view m_CloseSeparator;  // 添字と値の間に置く文字列
+        std::size_t      m_DigitsBegin = 0; // 添字の数字の開始位置
+        std::size_t      m_DigitsEnd = 0;   // 添字の数字の終了位置
+        std::size_t      m_Length = 0;      // 文字列の長さ
+    };
+
+    /// @brief 連続した数値の並びを "[添字]: 値" の形式で1行ずつ一括して書き出す。
+    /// 型ごとの最大文字数から全要素分の領域を一度に確保して直接書き込むため、
+    /// 要素ごとの再確保や文字列テーブルの参照が発生しない
+    /// @param out 追加先のバッファ
+    /// @param data 先頭要素へのポインタ
+    /// @param firstIndex 先頭要素の添字
+    /// @param count 要素数
+    /// @param open 添字の前に置く文字列
+    /// @param closeSeparator 添字と値の間に置く文字列
+    template <typename T>
+    void AppendNumericLines(
+        std::string& out,
+        const T* data,
+        std::size_t firstIndex,
+        std::size_t count,
+        std::string_view open,
+        std::string_view closeSeparator)
+    {
+        if (count == 0) return;
+
+        char lastIndex[MAX_NUMBER_CHARS];
+        const std::size_t maxIndexDigits = static_cast<std::size_t>(WriteUnsignedDecimal(lastIndex, static_cast<uint64_t>(firstIndex + count - 1)) - lastIndex);
+        NumericLinePrefix prefix(open, firstIndex, maxIndexDigits, closeSeparator);
+
+        // 各行の最大の長さの合計に、行頭の文字列を塊で書き込む分の余白を加えて確保する
+        const std::size_t lineCapacity = open.size() + maxIndexDigits + closeSeparator.size() + MaxNumberChars<T>() + 1;
+        const std::size_t start = out.size();
+        out.resize(start + lineCapacity * count + LINE_PREFIX_CHUNK);
+
+        char* p = out.data() + start;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            p = prefix.Write(p);
+            prefix.Increment();
+            p = WriteNumber(p, data[i]);
+            *p++ = '\n';
+        }
+        out.resize(static_cast<std::size_t>(p - out.data()));
+    }
+
+    /// @brief 連続した数値の並びを複数列にまとめて書き出す。
+    /// 各行の先頭に行の最初の要素の添字を置き、値は最も長い値の幅に右寄せで揃える
+    /// @param out 追加先のバッファ
+    /// @param data 先頭要素へのポインタ
+    /// @param firstIndex 先頭要素の添字
+    /// @param count 要素数
+    /// @param columns 1行に並べる要素数
+    /// @param open 添字の前に置く文字列
+    /// @param closeSeparator 添字と値の間に置く文字列
+    template <typename T>
+    void AppendNumericColumns(
+        std::string& out,
+        const T* data,
+        std::size_t firstIndex,
+        std::size_t count,
+        std::size_t columns,
+        std::string_view open,
+        std::string_view closeSeparator)
+    {
+        // 列幅を揃えるため、先に全要素の最大桁数を求める
+        std::size_t width = 0;
+        char temp[MAX_NUMBER_CHARS];
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t length = static_cast<std::size_t>(WriteNumber(temp, data[i]) - temp);
+            if (length > width) width = length;
+        }
+
+        const std::size_t rows = (count + columns - 1) / columns;
+        const std::size_t rowCapacity = open.size() + closeSeparator.size() + MAX_NUMBER_CHARS + columns * (width + 1) + 1;
+        const std::size_t start = out.size();
+        out.resize(start + rowCapacity * rows);
+
+        char* p = out.data() + start;
+        for (std::size_t row = 0; row < rows; ++row)
+        {
+            const std::size_t rowStart = row * columns;
+            std::memcpy(p, open.data(), open.size());
+            p += open.size();
+            p = WriteUnsignedDecimal(p, firstIndex + rowStart);
+            std::memcpy(p, closeSeparator.data(), closeSeparator.size());
+            p += closeSeparator.size();
+
+            const std::size_t rowEnd = (rowStart + columns < count) ? rowStart + columns : count;
+            for (std::size_t i = rowStart; i < rowEnd; ++i)
+            {
+                const std::size_t length = static_cast<std::size_t>(WriteNumber(temp, data[i]) - temp);
+                if (i != rowStart) *p++ = ' ';
+                std::memset(p, ' ', width - length);
+                p += width - length;
+                std::memcpy(p, temp, length);
+                p += length;
+            }
+            *p++ = '\n';
+        }
+        out.resize(static_cast<std::size_t>(p - out.data()));
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,570 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "FormatBuffer.h"
+#include "NumericFormat.h"
+
+namespace DebugPrint
+{
+    // 要約表示のヒストグラムの区間数
+    inline constexpr std::size_t SUMMARY_HISTOGRAM_BIN_COUNT = 10;
+
+    // ヒストグラムの棒の最大の長さ(文字数)
+    inline constexpr std::size_t SUMMARY_HISTOGRAM_BAR_WIDTH = 32;
+
+    // スカラー版の集計で独立に累積する系列の数。
+    // 浮動小数点数の加算の依存関係を分散させ、1要素ごとの待ち時間を隠す
+    inline constexpr std::size_t SUMMARY_SCALAR_LANES = 4;
+
+    /// @brief 数値の並びの要約統計。
+    /// 最小値・最大値・平均・標準偏差・ヒストグラムは有限の値のみから求める
+    template <typename T>
+    struct NumericSummary
+    {
+        std::size_t count       = 0;  // 全要素数
+        std::size_t finiteCount = 0;  // 有限の値の数
+        std::size_t nanCount    = 0;  // NaN の数
+        std::size_t infCount    = 0;  // 無限大の数
+        T           minimum{};        // 最小値
+        T           maximum{};        // 最大値
+        double      mean   = 0.0;     // 平均
+        double      stddev = 0.0;     // 標準偏差(母標準偏差)
+        std::array<double, SUMMARY_HISTOGRAM_BIN_COUNT>      binLowerBounds{};  // ヒストグラムの各区間の下限
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT> histogram{};       // 最小値～最大値を等分した区間ごとの要素数
+    };
+
+    /// @brief 1回目の走査で集計する値。
+    /// 合計と二乗和は桁落ちを抑えるため、最初の有限の値(shift)を引いた値で累積する
+    template <typename T>
+    struct SummaryMoments
+    {
+        std::size_t nanCount   = 0;    // NaN の数
+        std::size_t infCount   = 0;    // 無限大の数
+        T           minimum    = std::numeric_limits<T>::has_infinity ?  std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();     // 有限の値の最小値
+        T           maximum    = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();  // 有限の値の最大値
+        T           shift{};           // 合計と二乗和を求める前に各値から引く値
+        double      sum        = 0.0;  // 有限の値から shift を引いた値の合計
+        double      squaredSum = 0.0;  // 有限の値から shift を引いた値の二乗和
+    };
+
+    /// @brief 値が有限かどうかを判定する。整数は常に有限
+    template <typename T>
+    [[nodiscard]] bool IsFiniteValue(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            return std::isfinite(value);
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    /// @brief 最小値・最大値・合計・二乗和・NaN と無限大の数を集計する(スカラー版)
+    /// @param moments 集計先
+    /// @param data 先頭要素へのポインタ
+    /// @param count 要素数
+    template <typename T>
+    void AccumulateMomentsScalar(SummaryMoments<T>& moments, const T* data, std::size_t count)
+    {
+        const double shift = static_cast<double>(moments.shift);
+        std::array<double, SUMMARY_SCALAR_LANES> sums{};
+        std::array<double, SUMMARY_SCALAR_LANES> squaredSums{};
+        auto accumulate = [&](T value, std::size_t lane)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                if (std::isnan(value)) { ++moments.nanCount; return; }
+                if (std::isinf(value)) { ++moments.infCount; return; }
+            }
+            if (value < moments.minimum) moments.minimum = value;
+            if (value > moments.maximum) moments.maximum = value;
+            const double shifted = static_cast<double>(value) - shift;
+            sums[lane]        += shifted;
+            squaredSums[lane] += shifted * shifted;
+        };
+
+        std::size_t i = 0;
+        for (; i + SUMMARY_SCALAR_LANES <= count; i += SUMMARY_SCALAR_LANES)
+        {
+            for (std::size_t lane = 0; lane < SUMMARY_SCALAR_LANES; ++lane)
+            {
+                accumulate(data[i + lane], lane);
+            }
+        }
+        for (; i < count; ++i)
+        {
+            accumulate(data[i], 0);
+        }
+        for (std::size_t lane = 0; lane < SUMMARY_SCALAR_LANES; ++lane)
+        {
+            moments.sum        += sums[lane];
+            moments.squaredSum += squaredSums[lane];
+        }
+    }
+
+    /// @brief 合計または二乗和が double の範囲を超えた場合に、2のべき乗で縮小した値で集計し直す。
+    /// 絶対値が最大の有限の値が1未満になるよう縮小するため、差も二乗も要素数に比例する大きさに収まる
+    /// @param moments 集計先(合計と二乗和を上書きする)
+    /// @param data 先頭要素へのポインタ
+    /// @param count 要素数
+    /// @param exponent 縮小に使う2の指数(各値に 2^-exponent を掛ける)
+    template <typename T>
+    void AccumulateScaledMoments(SummaryMoments<T>& moments, const T* data, std::size_t count, int exponent)
+    {
+        const double scaledShift = std::ldexp(static_cast<double>(moments.shift), -exponent);
+        std::array<double, SUMMARY_SCALAR_LANES> sums{};
+        std::array<double, SUMMARY_SCALAR_LANES> squaredSums{};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!IsFiniteValue(data[i])) continue;
+            const double shifted = std::ldexp(static_cast<double>(data[i]), -exponent) - scaledShift;
+            sums[i % SUMMARY_SCALAR_LANES]        += shifted;
+            squaredSums[i % SUMMARY_SCALAR_LANES] += shifted * shifted;
+        }
+
+        moments.sum        = 0.0;
+        moments.squaredSum = 0.0;
+        for (std::size_t lane = 0; lane < SUMMARY_SCALAR_LANES; ++lane)
+        {
+            moments.sum        += sums[lane];
+            moments.squaredSum += squaredSums[lane];
+        }
+    }
+
+    /// @brief 有限の値をヒストグラムの区間に数える(スカラー版)。
+    /// 区間番号を割り算で見積もった後、区間の下限との比較で補正して AVX2 版と結果を一致させる
+    /// @param histogram 数える先
+    /// @param data 先頭要素へのポインタ
+    /// @param count 要素数
+    /// @param lowerBounds 各区間の下限
+    template <typename T>
+    void CountHistogramScalar(
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT>& histogram,
+        const T* data,
+        std::size_t count,
+        const std::array<double, SUMMARY_HISTOGRAM_BIN_COUNT>& lowerBounds)
+    {
+        constexpr std::size_t LAST_BIN = SUMMARY_HISTOGRAM_BIN_COUNT - 1;
+        const double halfMinimum = lowerBounds[0] * 0.5;
+        const double binScale    = 1.0 / (lowerBounds[1] * 0.5 - halfMinimum);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!IsFiniteValue(data[i])) continue;
+            const double value = static_cast<double>(data[i]);
+
+            const double estimate = (value * 0.5 - halfMinimum) * binScale;
+            std::size_t bin = estimate < static_cast<double>(LAST_BIN) ? static_cast<std::size_t>(estimate) : LAST_BIN;
+            while (bin > 0 && value < lowerBounds[bin]) --bin;
+            while (bin < LAST_BIN && value >= lowerBounds[bin + 1]) ++bin;
+            ++histogram[bin];
+        }
+    }
+
+#if defined(__AVX2__)
+    // AVX2 版のヒストグラム集計で32ビットの度数を合計に移すまでの反復回数
+    inline constexpr std::size_t SUMMARY_AVX2_FLUSH_INTERVAL = std::size_t(1) << 24;
+
+    /// @brief float の並びを AVX2 で8要素ずつ集計する。
+    /// 非有限の値は最小値・最大値・合計に影響しない値に置き換え、
+    /// NaN と無限大はブロックに非有限の値が含まれる場合のみ数える。
+    /// 合計と二乗和は精度を保つため double に変換して累積する
+    /// @return 処理した要素数(8の倍数)
+    inline std::size_t AccumulateMomentsAvx2(SummaryMoments<float>& moments, const float* data, std::size_t count)
+    {
+        const __m256  absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256  posInf  = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        const __m256  negInf  = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+        const __m256  shiftPs = _mm256_set1_ps(moments.shift);
+        const __m256d shiftPd = _mm256_set1_pd(static_cast<double>(moments.shift));
+
+        __m256  minimum     = posInf;
+        __m256  maximum     = negInf;
+        __m256d sumLow      = _mm256_setzero_pd();
+        __m256d sumHigh     = _mm256_setzero_pd();
+        __m256d squaredLow  = _mm256_setzero_pd();
+        __m256d squaredHigh = _mm256_setzero_pd();
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 value  = _mm256_loadu_ps(data + i);
+            const __m256 finite = _mm256_cmp_ps(_mm256_and_ps(value, absMask), posInf, _CMP_LT_OQ);
+
+            const unsigned nonFinite = ~static_cast<unsigned>(_mm256_movemask_ps(finite)) & 0xFFu;
+            if (nonFinite != 0)
+            {
+                const unsigned nan = static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(value, value, _CMP_UNORD_Q)));
+                moments.nanCount += static_cast<std::size_t>(std::popcount(nan));
+                moments.infCount += static_cast<std::size_t>(std::popcount(nonFinite) - std::popcount(nan));
+            }
+
+            minimum = _mm256_min_ps(minimum, _mm256_blendv_ps(posInf, value, finite));
+            maximum = _mm256_max_ps(maximum, _mm256_blendv_ps(negInf, value, finite));
+
+            // 非有限の値は shift に置き換え、引いた結果が0になるようにする
+            const __m256  finiteValue = _mm256_blendv_ps(shiftPs, value, finite);
+            const __m256d low  = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(finiteValue)), shiftPd);
+            const __m256d high = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(finiteValue, 1)), shiftPd);
+            sumLow      = _mm256_add_pd(sumLow, low);
+            sumHigh     = _mm256_add_pd(sumHigh, high);
+            squaredLow  = _mm256_add_pd(squaredLow, _mm256_mul_pd(low, low));
+            squaredHigh = _mm256_add_pd(squaredHigh, _mm256_mul_pd(high, high));
+        }
+
+        alignas(32) float  minLanes[8];
+        alignas(32) float  maxLanes[8];
+        alignas(32) double sumLanes[4];
+        alignas(32) double squaredLanes[4];
+        _mm256_store_ps(minLanes, minimum);
+        _mm256_store_ps(maxLanes, maximum);
+        _mm256_store_pd(sumLanes, _mm256_add_pd(sumLow, sumHigh));
+        _mm256_store_pd(squaredLanes, _mm256_add_pd(squaredLow, squaredHigh));
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            if (minLanes[lane] < moments.minimum) moments.minimum = minLanes[lane];
+            if (maxLanes[lane] > moments.maximum) moments.maximum = maxLanes[lane];
+        }
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            moments.sum        += sumLanes[lane];
+            moments.squaredSum += squaredLanes[lane];
+        }
+        return i;
+    }
+
+    /// @brief double の並びを AVX2 で4要素ずつ集計する
+    /// @return 処理した要素数(4の倍数)
+    inline std::size_t AccumulateMomentsAvx2(SummaryMoments<double>& moments, const double* data, std::size_t count)
+    {
+        const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+        const __m256d posInf  = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+        const __m256d negInf  = _mm256_set1_pd(-std::numeric_limits<double>::infinity());
+        const __m256d shift   = _mm256_set1_pd(moments.shift);
+
+        __m256d minimum = posInf;
+        __m256d maximum = negInf;
+        __m256d sum     = _mm256_setzero_pd();
+        __m256d squared = _mm256_setzero_pd();
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m256d value  = _mm256_loadu_pd(data + i);
+            const __m256d finite = _mm256_cmp_pd(_mm256_and_pd(value, absMask), posInf, _CMP_LT_OQ);
+
+            const unsigned nonFinite = ~static_cast<unsigned>(_mm256_movemask_pd(finite)) & 0xFu;
+            if (nonFinite != 0)
+            {
+                const unsigned nan = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(value, value, _CMP_UNORD_Q)));
+                moments.nanCount += static_cast<std::size_t>(std::popcount(nan));
+                moments.infCount += static_cast<std::size_t>(std::popcount(nonFinite) - std::popcount(nan));
+            }
+
+            minimum = _mm256_min_pd(minimum, _mm256_blendv_pd(posInf, value, finite));
+            maximum = _mm256_max_pd(maximum, _mm256_blendv_pd(negInf, value, finite));
+
+            const __m256d shifted = _mm256_sub_pd(_mm256_blendv_pd(shift, value, finite), shift);
+            sum     = _mm256_add_pd(sum, shifted);
+            squared = _mm256_add_pd(squared, _mm256_mul_pd(shifted, shifted));
+        }
+
+        alignas(32) double minLanes[4];
+        alignas(32) double maxLanes[4];
+        alignas(32) double sumLanes[4];
+        alignas(32) double squaredLanes[4];
+        _mm256_store_pd(minLanes, minimum);
+        _mm256_store_pd(maxLanes, maximum);
+        _mm256_store_pd(sumLanes, sum);
+        _mm256_store_pd(squaredLanes, squared);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if (minLanes[lane] < moments.minimum) moments.minimum = minLanes[lane];
+            if (maxLanes[lane] > moments.maximum) moments.maximum = maxLanes[lane];
+            moments.sum        += sumLanes[lane];
+            moments.squaredSum += squaredLanes[lane];
+        }
+        return i;
+    }
+
+    /// @brief 有限の値をヒストグラムの区間に AVX2 で8要素ずつ数える。
+    /// 各区間の下限以上の値の数を比較だけで数え、隣り合う区間の差から度数を求めるため、
+    /// 要素ごとの度数表への書き込みが発生しない。
+    /// 下限は「下限以上の最小の float」に直して比較し、スカラー版と結果を一致させる
+    /// @return 処理した要素数(8の倍数)
+    inline std::size_t CountHistogramAvx2(
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT>& histogram,
+        const float* data,
+        std::size_t count,
+        const std::array<double, SUMMARY_HISTOGRAM_BIN_COUNT>& lowerBounds)
+    {
+        __m256 bounds[SUMMARY_HISTOGRAM_BIN_COUNT];
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            float bound = static_cast<float>(lowerBounds[bin]);
+            if (static_cast<double>(bound) < lowerBounds[bin])
+            {
+                bound = std::nextafter(bound, std::numeric_limits<float>::infinity());
+            }
+            bounds[bin] = _mm256_set1_ps(bound);
+        }
+        const __m256 posInf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+
+        // atLeast[k] は区間 k の下限以上の有限の値の数
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT> atLeast{};
+        std::size_t i = 0;
+        while (i + 8 <= count)
+        {
+            __m256i counters[SUMMARY_HISTOGRAM_BIN_COUNT];
+            for (__m256i& counter : counters) counter = _mm256_setzero_si256();
+
+            const std::size_t blockEnd = (count - i) / 8 > SUMMARY_AVX2_FLUSH_INTERVAL ? i + SUMMARY_AVX2_FLUSH_INTERVAL * 8 : count;
+            for (; i + 8 <= blockEnd; i += 8)
+            {
+                const __m256 value  = _mm256_loadu_ps(data + i);
+                const __m256 finite = _mm256_cmp_ps(value, posInf, _CMP_LT_OQ);
+                for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+                {
+                    // 比較結果は真のとき全ビット1(-1)のため、引くことで1を加える
+                    const __m256 mask = _mm256_and_ps(_mm256_cmp_ps(value, bounds[bin], _CMP_GE_OQ), finite);
+                    counters[bin] = _mm256_sub_epi32(counters[bin], _mm256_castps_si256(mask));
+                }
+            }
+
+            for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+            {
+                alignas(32) uint32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counters[bin]);
+                for (uint32_t lane : lanes) atLeast[bin] += lane;
+            }
+        }
+
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            const std::size_t next = bin + 1 < SUMMARY_HISTOGRAM_BIN_COUNT ? atLeast[bin + 1] : 0;
+            histogram[bin] += atLeast[bin] - next;
+        }
+        return i;
+    }
+
+    /// @brief double の有限の値をヒストグラムの区間に AVX2 で4要素ずつ数える
+    /// @return 処理した要素数(4の倍数)
+    inline std::size_t CountHistogramAvx2(
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT>& histogram,
+        const double* data,
+        std::size_t count,
+        const std::array<double, SUMMARY_HISTOGRAM_BIN_COUNT>& lowerBounds)
+    {
+        __m256d bounds[SUMMARY_HISTOGRAM_BIN_COUNT];
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            bounds[bin] = _mm256_set1_pd(lowerBounds[bin]);
+        }
+        const __m256d posInf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+
+        __m256i counters[SUMMARY_HISTOGRAM_BIN_COUNT];
+        for (__m256i& counter : counters) counter = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m256d value  = _mm256_loadu_pd(data + i);
+            const __m256d finite = _mm256_cmp_pd(value, posInf, _CMP_LT_OQ);
+            for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+            {
+                const __m256d mask = _mm256_and_pd(_mm256_cmp_pd(value, bounds[bin], _CMP_GE_OQ), finite);
+                counters[bin] = _mm256_sub_epi64(counters[bin], _mm256_castpd_si256(mask));
+            }
+        }
+
+        std::array<std::size_t, SUMMARY_HISTOGRAM_BIN_COUNT> atLeast{};
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), counters[bin]);
+            for (uint64_t lane : lanes) atLeast[bin] += static_cast<std::size_t>(lane);
+        }
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            const std::size_t next = bin + 1 < SUMMARY_HISTOGRAM_BIN_COUNT ? atLeast[bin + 1] : 0;
+            histogram[bin] += atLeast[bin] - next;
+        }
+        return i;
+    }
+#endif
+
+    /// @brief 数値の並びの要約統計を求める。
+    /// 1回目の走査で最小値・最大値・合計・二乗和・NaN と無限大の数を集計し、
+    /// 最小値と最大値が決まった後の2回目の走査でヒストグラムを数える。
+    /// AVX2 が有効な場合は float と double の両方の走査をベクトル化する
+    /// @param data 先頭要素へのポインタ
+    /// @param count 要素数
+    /// @return 要約統計
+    template <typename T>
+    [[nodiscard]] NumericSummary<T> ComputeNumericSummary(const T* data, std::size_t count)
+    {
+        NumericSummary<T> summary;
+        summary.count = count;
+
+        // 合計と二乗和の桁落ちを抑えるため、最初の有限の値を基準にする
+        SummaryMoments<T> moments;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (IsFiniteValue(data[i]))
+            {
+                moments.shift = data[i];
+                break;
+            }
+        }
+
+        std::size_t processed = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            processed = AccumulateMomentsAvx2(moments, data, count);
+        }
+#endif
+        AccumulateMomentsScalar(moments, data + processed, count - processed);
+
+        summary.nanCount    = moments.nanCount;
+        summary.infCount    = moments.infCount;
+        summary.finiteCount = count - moments.nanCount - moments.infCount;
+        if (summary.finiteCount == 0)
+        {
+            return summary;
+        }
+
+        // 1e300 前後の値などで合計か二乗和が double の範囲を超えた場合は、縮小した値で集計し直す
+        int exponent = 0;
+        if (!std::isfinite(moments.sum) || !std::isfinite(moments.squaredSum))
+        {
+            const double largest = std::max(std::fabs(static_cast<double>(moments.minimum)), std::fabs(static_cast<double>(moments.maximum)));
+            std::frexp(largest, &exponent);
+            AccumulateScaledMoments(moments, data, count, exponent);
+        }
+
+        const double finiteCount = static_cast<double>(summary.finiteCount);
+        const double shiftedMean = moments.sum / finiteCount;
+        const double variance    = moments.squaredSum / finiteCount - shiftedMean * shiftedMean;
+        summary.minimum = moments.minimum;
+        summary.maximum = moments.maximum;
+        summary.mean    = static_cast<double>(moments.shift) + std::ldexp(shiftedMean, exponent);
+        // 丸め誤差でわずかに負になった分散のみ0とし、無限大や NaN はそのまま表示する
+        summary.stddev  = std::ldexp(variance < 0.0 ? 0.0 : std::sqrt(variance), exponent);
+
+        // 全要素が同じ値の場合は区間を分けられないため、すべて先頭の区間に数える
+        if (!(summary.maximum > summary.minimum))
+        {
+            summary.binLowerBounds.fill(static_cast<double>(summary.minimum));
+            summary.histogram[0] = summary.finiteCount;
+            return summary;
+        }
+
+        // 区間の下限は最小値と最大値の差が double の範囲を超えないよう半分にした値で求める
+        const double halfMinimum = static_cast<double>(summary.minimum) * 0.5;
+        const double halfWidth   = (static_cast<double>(summary.maximum) * 0.5 - halfMinimum) / SUMMARY_HISTOGRAM_BIN_COUNT;
+        for (std::size_t bin = 0; bin < SUMMARY_HISTOGRAM_BIN_COUNT; ++bin)
+        {
+            summary.binLowerBounds[bin] = (halfMinimum + halfWidth * static_cast<double>(bin)) * 2.0;
+        }
+
+        processed = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            processed = CountHistogramAvx2(summary.histogram, data, count, summary.binLowerBounds);
+        }
+#endif
+        CountHistogramScalar(summary.histogram, data + processed, count - processed, summary.binLowerBounds);
+        return summary;
+    }
+
+    /// @brief 数値の配列の要素を表示せず、要素数と要約統計(最小値・最大値・平均・
+    /// 標準偏差・NaN と無限大の数・ヒストグラム)をコンソールに表示する。
+    /// 巨大なバッファの値の範囲や NaN の混入を、全要素を出力せずに確認するために使う。
+    /// PRINT_VARIABLE_SUMMARY マクロから呼び出される
+    /// @param name 変数名の文字列
+    /// @param range 表示する数値の配列(std::vector・std::array・C配列など)
+    /// @param color 表示色
+    template <NumericContiguousRange R>
+    void PrintVariableSummary(const char* name, const R& range, Color color = PRINT_COLOR::DEFAULT)
+    {
+        using T = std::remove_cvref_t<std::ranges::range_value_t<const R>>;
+        const auto summary = ComputeNumericSummary<T>(std::ranges::data(range), static_cast<std::size_t>(std::ranges::size(range)));
+
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        const std::string& separator = pairSeparatorString();
+
+        auto appendLine = [&](const std::string& label, const auto& value)
+        {
+            out += label;
+            out += separator;
+            AppendValue(out, value);
+            out += '\n';
+        };
+
+        out += variableString();
+        out += separator;
+        out += name;
+        out += '\n';
+        appendLine(elementCountString(), summary.count);
+        if (summary.finiteCount > 0)
+        {
+            appendLine(minimumString(), summary.minimum);
+            appendLine(maximumString(), summary.maximum);
+            appendLine(meanString(), summary.mean);
+            appendLine(stddevString(), summary.stddev);
+        }
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            appendLine(nanCountString(), summary.nanCount);
+            appendLine(infCountString(), summary.infCount);
+        }
+
+        if (summary.finiteCount > 0)
+        {
+            std::size_t peak = 0;
+            for (std::size_t binCount : summary.histogram)
+            {
+                if (binCount > peak) peak = binCount;
+            }
+
+            out += histogramString();
+            out += separator;
+            out += '\n';
+            // 全要素が同じ値の場合は区間が1つになる
+            const std::size_t binCount = summary.maximum > summary.minimum ? SUMMARY_HISTOGRAM_BIN_COUNT : 1;
+            for (std::size_t i = 0; i < binCount; ++i)
+            {
+                out += "  ";
+                AppendValue(out, summary.binLowerBounds[i]);
+                out += separator;
+                out.append(summary.histogram[i] * SUMMARY_HISTOGRAM_BAR_WIDTH / peak, '#');
+                out += ' ';
+                AppendValue(out, summary.histogram[i]);
+                out += '\n';
+            }
+        }
+
+        PrintMessage(out, color);
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,230 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define DEBUG_PRINT_HAS_PERF_EVENT
+#endif
+
+namespace DebugPrint
+{
+    /// @brief パフォーマンスカウンタの種類
+    enum class PerfCounter
+    {
+        Cycles,           ///< CPUサイクル数(ハードウェア)
+        Instructions,     ///< 実行命令数(ハードウェア)
+        CacheMisses,      ///< キャッシュミス数(ハードウェア)
+        BranchMisses,     ///< 分岐予測ミス数(ハードウェア)
+        ContextSwitches,  ///< コンテキストスイッチ数(ソフトウェア)
+        TaskClock,        ///< スレッドのCPU時間(ナノ秒・ソフトウェア)
+        PageFaults,       ///< ページフォルト数(ソフトウェア)
+        Count,
+    };
+
+    // カウンタの種類数
+    inline constexpr std::size_t PERF_COUNTER_COUNT = static_cast<std::size_t>(PerfCounter::Count);
+
+    /// @brief パフォーマンスカウンタの読み取り値。
+    /// 値は多重化の補正をしていない生のカウントで、カウンタが有効だった時間と実際に計測した時間を一緒に保持する。
+    /// 補正は Get で行うため、差分は生の値どうしで求めてから補正される。
+    /// 開けなかったカウンタは available が false になる
+    struct PerfCounterValues
+    {
+        std::array<uint64_t, PERF_COUNTER_COUNT> values{};     // 各カウンタの生の値
+        std::array<uint64_t, PERF_COUNTER_COUNT> enabled{};    // 各カウンタが有効だった時間(ナノ秒)
+        std::array<uint64_t, PERF_COUNTER_COUNT> running{};    // 各カウンタを実際に計測した時間(ナノ秒)
+        std::array<bool, PERF_COUNTER_COUNT>     available{};  // 各カウンタが使用可能かどうか
+
+        /// @brief 指定カウンタの値を取得する。
+        /// 他の計測と多重化されて一部の時間しか計測されなかった場合は、有効だった時間と計測した時間の比で補正する
+        [[nodiscard]] uint64_t Get(PerfCounter counter) const
+        {
+            const std::size_t index = static_cast<std::size_t>(counter);
+            const uint64_t value = values[index];
+            if (running[index] == 0 || running[index] >= enabled[index]) return value;
+            return static_cast<uint64_t>(static_cast<long double>(value) * enabled[index] / running[index]);
+        }
+
+        /// @brief 指定カウンタが使用可能かどうかを取得する
+        [[nodiscard]] bool Has(PerfCounter counter) const { return available[static_cast<std::size_t>(counter)]; }
+
+        /// @brief いずれかのカウンタが使用可能かどうかを取得する
+        [[nodiscard]] bool HasAny() const
+        {
+            for (bool a : available) if (a) return true;
+            return false;
+        }
+
+        /// @brief 2つの読み取り値の差分を求める。
+        /// 補正済みの値どうしを引くと補正の比が異なるために負になり得るため、生の値と時間の差分を求める。
+        /// 区間内で一度も計測されなかったカウンタは値を推定できないため使用不可とする
+        [[nodiscard]] PerfCounterValues operator-(const PerfCounterValues& other) const
+        {
+            PerfCounterValues result;
+            for (std::size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+            {
+                // 生の値と時間は単調増加だが、念のため 0 で止める
+                result.values[i]    = values[i]  > other.values[i]  ? values[i]  - other.values[i]  : 0;
+                result.enabled[i]   = enabled[i] > other.enabled[i] ? enabled[i] - other.enabled[i] : 0;
+                result.running[i]   = running[i] > other.running[i] ? running[i] - other.running[i] : 0;
+                result.available[i] = available[i] && other.available[i]
+                                   && !(result.running[i] == 0 && result.enabled[i] > 0);
+            }
+            return result;
+        }
+    };
+
+    /// @brief スレッドごとに perf_event_open で開いたカウンタを保持するクラス。
+    /// ハードウェアカウンタ(サイクル・命令・キャッシュミス・分岐ミス)はサイクル数を先頭とするグループ、
+    /// ソフトウェアカウンタ(タスククロック・ページフォルト・コンテキストスイッチ)はタスククロックを先頭とするグループとして開き、
+    /// それぞれ先頭のカウンタから1回の read でまとめて読み取る。
+    /// ハードウェアカウンタが他の計測と多重化された場合の補正に使うため、有効だった時間と実際に計測した時間も読み取る。
+    /// コンテナなどでハードウェアイベントが使えない場合はソフトウェアカウンタのみで計測する。
+    /// Linux 以外の環境ではすべてのカウンタが使用不可になる
+    class PerfCounterGroup
+    {
+    public:
+
+        /// @brief 現在のスレッド用のカウンタを取得する。初回呼び出し時にカウンタを開く
+        [[nodiscard]] static PerfCounterGroup& GetThreadInstance()
+        {
+            thread_local PerfCounterGroup instance;
+            return instance;
+        }
+
+        /// @brief 全カウンタの現在値を読み取る
+        [[nodiscard]] PerfCounterValues Read() const
+        {
+            PerfCounterValues result;
+#if defined(DEBUG_PRINT_HAS_PERF_EVENT)
+            for (const EventGroup& group : m_Groups)
+            {
+                ReadGroup(group, result);
+            }
+#endif
+            return result;
+        }
+
+        // コピー・ムーブ禁止
+        PerfCounterGroup(const PerfCounterGroup&) = delete;
+        PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+        PerfCounterGroup(PerfCounterGroup&&) = delete;
+        PerfCounterGroup& operator=(PerfCounterGroup&&) = delete;
+
+    private:
+
+        /// @brief 1回の read でまとめて読み取るカウンタのグループ
+        struct EventGroup
+        {
+            int leaderFd = -1;  // 先頭のカウンタのファイルディスクリプタ(-1 は使用不可)
+            std::array<PerfCounter, PERF_COUNTER_COUNT> counters{};  // 読み取り結果に並ぶ順のカウンタの種類
+            std::size_t size = 0;  // グループに含まれるカウンタの数
+        };
+
+        /// @brief コンストラクタ。現在のスレッドを対象にカウンタを開く
+        PerfCounterGroup()
+        {
+            m_Fds.fill(-1);
+#if defined(DEBUG_PRINT_HAS_PERF_EVENT)
+            EventGroup& hardware = m_Groups[0];
+            Open(hardware, PerfCounter::Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true);
+            // サイクル数が開けない環境では他のハードウェアカウンタも使えないため試さない
+            if (hardware.leaderFd >= 0)
+            {
+                Open(hardware, PerfCounter::Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true);
+                Open(hardware, PerfCounter::CacheMisses,  PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true);
+                Open(hardware, PerfCounter::BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true);
+            }
+
+            EventGroup& software = m_Groups[1];
+            Open(software, PerfCounter::TaskClock,  PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, true);
+            if (software.leaderFd >= 0)
+            {
+                Open(software, PerfCounter::PageFaults, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, true);
+                // コンテキストスイッチはカーネル内で発生するため、カーネル空間を除外すると常に 0 になる。
+                // perf_event_paranoid の設定によってはカーネル空間を含むカウンタを開けないが、その場合は使用不可のままにする
+                Open(software, PerfCounter::ContextSwitches, PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false);
+            }
+#endif
+        }
+
+        /// @brief デストラクタ。開いたカウンタを閉じる
+        ~PerfCounterGroup()
+        {
+#if defined(DEBUG_PRINT_HAS_PERF_EVENT)
+            for (int fd : m_Fds)
+            {
+                if (fd >= 0) close(fd);
+            }
+#endif
+        }
+
+#if defined(DEBUG_PRINT_HAS_PERF_EVENT)
+        /// @brief カウンタを1つ開いてグループに加える。グループが空の場合は先頭のカウンタとして開く。
+        /// 失敗した場合は使用不可のままにする
+        /// @param group 加えるグループ
+        /// @param counter カウンタの種類
+        /// @param type perf_event_attr の type
+        /// @param config perf_event_attr の config
+        /// @param excludeKernel カーネル空間を計測から除外する場合は true
+        void Open(EventGroup& group, PerfCounter counter, uint32_t type, uint64_t config, bool excludeKernel)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size           = sizeof(attr);
+            attr.type           = type;
+            attr.config         = config;
+            attr.exclude_kernel = excludeKernel ? 1 : 0;  // 権限の低い環境でも開けるよう、通常はユーザー空間のみ計測する
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid = 0, cpu = -1 で呼び出したスレッドをどのCPU上でも計測する
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group.leaderFd, 0);
+            if (fd < 0) return;
+
+            m_Fds[static_cast<std::size_t>(counter)] = static_cast<int>(fd);
+            if (group.leaderFd < 0) group.leaderFd = static_cast<int>(fd);
+            group.counters[group.size++] = counter;
+        }
+
+        /// @brief グループの全カウンタを1回の read で読み取り、生の値と有効・計測時間を格納する
+        /// @param group 読み取るグループ
+        /// @param result 読み取り結果の格納先
+        static void ReadGroup(const EventGroup& group, PerfCounterValues& result)
+        {
+            if (group.leaderFd < 0) return;
+
+            // PERF_FORMAT_GROUP の読み取り結果: カウンタ数, 有効だった時間, 計測した時間, 各カウンタの値
+            std::array<uint64_t, 3 + PERF_COUNTER_COUNT> buffer{};
+            const ssize_t bytes = read(group.leaderFd, buffer.data(), sizeof(buffer));
+            if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) return;
+
+            const uint64_t count = buffer[0];
+            for (std::size_t i = 0; i < group.size && i < count; ++i)
+            {
+                const std::size_t index = static_cast<std::size_t>(group.counters[i]);
+                result.values[index]    = buffer[3 + i];
+                result.enabled[index]   = buffer[1];
+                result.running[index]   = buffer[2];
+                result.available[index] = true;
+            }
+        }
+
+        std::array<EventGroup, 2> m_Groups;  // ハードウェアカウンタとソフトウェアカウンタのグループ
+#endif
+
+        std::array<int, PERF_COUNTER_COUNT> m_Fds;  // 各カウンタのファイルディスクリプタ(-1 は使用不可)
+    };
+
+    /// @brief 現在のスレッドのパフォーマンスカウンタを読み取る
+    [[nodiscard]] inline PerfCounterValues ReadThreadPerfCounters()
+    {
+        return PerfCounterGroup::GetThreadInstance().Read();
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,465 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "MacroList.h"
+#include "TemplateStrings.h"
+#include "DebugPrintConfig.h"
+#include "PrintFunction.h"
+#include "FormatBuffer.h"
+
+// ダイアログを専用スレッドで表示するかどうか。
+// Emscripten の SweetAlert2 はメインスレッドの DOM を操作するため、スレッドを使える場合も対象外とする
+#if defined(DEBUG_PRINT_HAS_THREADS) && !defined(__EMSCRIPTEN__)
+#define DEBUG_PRINT_POPUP_THREAD
+#include <thread>
+#endif
+
+namespace DebugPrint
+{
+#if defined(__EMSCRIPTEN__)
+    /// @brief Emscripten 環境で、ダイアログが閉じられた後に呼び出す関数を番号で管理するシングルトンクラス。
+    /// JavaScript 側には番号だけを渡し、SweetAlert2 のダイアログが閉じられたら DebugPrintPopupClosed で番号が返される。
+    /// ダイアログの表示を待たないため、-sASYNCIFY なしで閉じられた後の処理を行える
+    class PopupCallbacks
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static PopupCallbacks& GetInstance()
+        {
+            static PopupCallbacks instance;
+            return instance;
+        }
+
+        /// @brief 閉じられた後に呼び出す関数を登録する
+        /// @param callback 呼び出す関数
+        /// @return JavaScript 側に渡す番号(0 以外)
+        uint32_t Register(std::function<void()> callback)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (++m_NextId == 0) ++m_NextId;
+            m_Callbacks.emplace(m_NextId, std::move(callback));
+            return m_NextId;
+        }
+
+        /// @brief 番号に対応する関数を呼び出し、登録を解除する
+        /// @param id Register で得た番号
+        void Invoke(uint32_t id)
+        {
+            std::function<void()> callback;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                const auto it = m_Callbacks.find(id);
+                if (it == m_Callbacks.end()) return;
+                callback = std::move(it->second);
+                m_Callbacks.erase(it);
+            }
+            callback();
+        }
+
+        // コピー・ムーブ禁止
+        PopupCallbacks(const PopupCallbacks&) = delete;
+        PopupCallbacks& operator=(const PopupCallbacks&) = delete;
+        PopupCallbacks(PopupCallbacks&&) = delete;
+        PopupCallbacks& operator=(PopupCallbacks&&) = delete;
+
+    private:
+
+        PopupCallbacks() = default;
+        ~PopupCallbacks() = default;
+
+        std::mutex m_Mutex;  // 全メンバーの排他制御用
+        std::unordered_map<uint32_t, std::function<void()>> m_Callbacks;  // 番号ごとの閉じられた後に呼び出す関数
+        uint32_t   m_NextId = 0;  // 最後に割り当てた番号
+    };
+#endif
+
+    /// @brief ポップアップの表示要求1件分
+    struct PopupRequest
+    {
+        std::string         message;                // 表示するメッセージ
+        PopupIcon           icon       = PopupIcon::None;  // アイコン種別
+        const char*         funcName   = nullptr;   // 呼び出し元の関数名(詳細情報を表示しない場合は nullptr)
+        const char*         fileName   = nullptr;   // 呼び出し元のファイル名(詳細情報を表示しない場合は nullptr)
+        int                 lineNumber = 0;         // 呼び出し元の行番号
+        uint64_t            count      = 1;         // 表示前にまとめられた同じ要求の件数
+        std::promise<void>* done       = nullptr;   // 閉じられたことを通知する先(待機しない場合は nullptr)
+        std::function<void()> onClosed = nullptr;   // 閉じられた後に呼び出す関数(空の場合は呼び出さない)
+    };
+
+    /// @brief ポップアップの表示要求を受け付け、専用スレッドで1件ずつ表示するシングルトンクラス。
+    /// tinyfiledialogs のダイアログは閉じられるまで呼び出し元をブロックするため、
+    /// POPUP_* マクロは要求をキューに積むだけで即座に戻る。
+    /// ダイアログは専用スレッドが積まれた順に1つずつ表示するため、複数が同時に開くことはない。
+    /// 表示待ちの要求と同じ要求は1件にまとめて発生回数を数え、
+    /// 1分あたりの表示数が上限に達した後の要求はダイアログを開かずにコンソールにのみ表示する。
+    /// ダイアログを表示できない環境(ディスプレイのないサーバーなど)では、すべての要求をコンソールにのみ表示する
+    class PopupQueue
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static PopupQueue& GetInstance()
+        {
+            static PopupQueue instance;
+            return instance;
+        }
+
+        /// @brief ポップアップの表示要求をキューに積み、表示を待たずに戻る。
+        /// 表示待ちの同じ要求があれば、その発生回数を増やすだけで新たなダイアログは開かない。
+        /// 1分あたりの表示数が上限に達している場合はコンソールにのみ表示する。
+        /// 専用スレッドを使わない環境ではその場で表示する
+        /// @param request 表示要求
+        void Enqueue(PopupRequest request)
+        {
+            if (!DebugPrintConfig::GetInstance().IsPopupAvailable())
+            {
+                PrintToConsole(request, popupUnavailableString());
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            for (PopupRequest& pending : m_Requests)
+            {
+                if (IsSameRequest(pending, request))
+                {
+                    ++pending.count;
+                    return;
+                }
+            }
+
+            if (!AdmitDialogLocked())
+            {
+                lock.unlock();
+                PrintToConsole(request, popupSuppressedString());
+                return;
+            }
+
+#if defined(DEBUG_PRINT_POPUP_THREAD)
+            m_Requests.push_back(std::move(request));
+            StartWorker();
+            lock.unlock();
+            m_Condition.notify_one();
+#else
+            lock.unlock();
+            Show(request);
+#endif
+        }
+
+        /// @brief ポップアップの表示要求をキューに積み、そのダイアログが閉じられるまで待機する。
+        /// 先に積まれたダイアログがあれば、それらが閉じられた後に表示される。
+        /// 確認のための表示のため、まとめたり上限で省略したりはしないが、表示数には数える。
+        /// Emscripten では -sASYNCIFY なしで待機できないため、表示して即座に戻る(閉じられた後の処理は onClosed を使う)
+        /// @param request 表示要求
+        void ShowAndWait(PopupRequest request)
+        {
+            if (!DebugPrintConfig::GetInstance().IsPopupAvailable())
+            {
+                PrintToConsole(request, popupUnavailableString());
+                return;
+            }
+
+#if defined(DEBUG_PRINT_POPUP_THREAD)
+            std::promise<void> done;
+            std::future<void> closed = done.get_future();
+            request.done = &done;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                RecordDialogLocked();
+                m_Requests.push_back(std::move(request));
+                StartWorker();
+            }
+            m_Condition.notify_one();
+            closed.wait();
+#else
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                RecordDialogLocked();
+            }
+            Show(request);
+#endif
+        }
+
+        // コピー・ムーブ禁止
+        PopupQueue(const PopupQueue&) = delete;
+        PopupQueue& operator=(const PopupQueue&) = delete;
+        PopupQueue(PopupQueue&&) = delete;
+        PopupQueue& operator=(PopupQueue&&) = delete;
+
+    private:
+
+        /// @brief コンストラクタ。
+        /// ダイアログの表示で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+        PopupQueue()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)GetOutputMutex();
+            (void)DuplicateFilter::GetInstance();
+        }
+
+        /// @brief デストラクタ。キューに残っているダイアログをすべて表示してから専用スレッドを止める
+        ~PopupQueue()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Condition.notify_one();
+#if defined(DEBUG_PRINT_POPUP_THREAD)
+            if (m_Worker.joinable()) m_Worker.join();
+#endif
+        }
+
+        /// @brief 2つの要求が同じダイアログになるかを判定する。
+        /// 待機中の呼び出し元や閉じられた後に呼び出す関数がある要求はそれぞれ個別に表示するため、まとめない。
+        /// 関数名・ファイル名は呼び出し箇所の文字列リテラルのため、アドレスで比較する
+        static bool IsSameRequest(const PopupRequest& pending, const PopupRequest& request)
+        {
+            return pending.done == nullptr && !pending.onClosed && !request.onClosed &&
+                   pending.icon == request.icon &&
+                   pending.lineNumber == request.lineNumber &&
+                   pending.funcName == request.funcName &&
+                   pending.fileName == request.fileName &&
+                   pending.message == request.message;
+        }
+
+        /// @brief 直近1分間の表示数が上限未満であれば、表示する分として数えて true を返す。
+        /// m_Mutex を保持した状態で呼ぶ
+        bool AdmitDialogLocked()
+        {
+            const uint32_t maxPerMinute = DebugPrintConfig::GetInstance().GetPopupMaxPerMinute();
+            PruneDialogTimesLocked();
+            if (maxPerMinute != 0 && m_DialogTimes.size() >= maxPerMinute) return false;
+            RecordDialogLocked();
+            return true;
+        }
+
+        /// @brief 表示したダイアログの時刻を記録する。m_Mutex を保持した状態で呼ぶ
+        void RecordDialogLocked()
+        {
+            PruneDialogTimesLocked();
+            m_DialogTimes.push_back(std::chrono::steady_clock::now());
+        }
+
+        /// @brief 1分より前の表示時刻を取り除く。m_Mutex を保持した状態で呼ぶ
+        void PruneDialogTimesLocked()
+        {
+            const auto windowStart = std::chrono::steady_clock::now() - std::chrono::minutes(1);
+            while (!m_DialogTimes.empty() && m_DialogTimes.front() < windowStart)
+            {
+                m_DialogTimes.pop_front();
+            }
+        }
+
+        /// @brief ダイアログを開かなかったポップアップを、ポップアップの種類に応じた色でコンソールに表示する
+        /// @param request 表示しなかった要求
+        /// @param reason メッセージの前に表示する、ダイアログを開かなかった理由
+        static void PrintToConsole(const PopupRequest& request, const std::string& reason)
+        {
+            const DebugPrintConfig& config = DebugPrintConfig::GetInstance();
+            const Color color = request.icon == PopupIcon::Error   ? config.GetPopupErrorMessageColor()
+                              : request.icon == PopupIcon::Warning ? config.GetPopupWarningMessageColor()
+                              : config.GetPopupMessageColor();
+
+            ScopedFormatBuffer buffer;
+            std::string& out = buffer.Get();
+            out += reason;
+            out += '\n';
+            out += request.message;
+            if (request.funcName != nullptr && request.fileName != nullptr)
+            {
+                PrintAppErrorInfo(out, request.funcName, request.fileName, request.lineNumber, color);
+            }
+            else
+            {
+                out += '\n';
+                PrintMessage(out, color);
+            }
+
+            // 閉じるダイアログがないため、閉じられた後の処理はすぐに呼び出す
+            if (request.onClosed) request.onClosed();
+        }
+
+        /// @brief ダイアログを1件表示し、閉じられたら閉じられた後に呼び出す関数を呼び出して待機中の呼び出し元に通知する。
+        /// 同じ要求をまとめた場合は発生回数をメッセージに添える
+        /// @param request 表示要求
+        static void Show(const PopupRequest& request)
+        {
+#if defined(__EMSCRIPTEN__)
+            // SweetAlert2 のダイアログは閉じられるのを待たないため、閉じられた後の処理は JavaScript 側から呼び出す
+            const uint32_t callbackId = request.onClosed ? PopupCallbacks::GetInstance().Register(request.onClosed) : 0;
+#else
+            const uint32_t callbackId = 0;
+#endif
+            if (request.count > 1)
+            {
+                ScopedFormatBuffer buffer;
+                std::string& message = buffer.Get();
+                message += request.message;
+                message += "\n\n";
+                message += popupRepeatedString();
+                message += pairSeparatorString();
+                AppendValue(message, request.count);
+                ShowPopup(message, request.icon, request.funcName, request.fileName, request.lineNumber, callbackId);
+            }
+            else
+            {
+                ShowPopup(request.message, request.icon, request.funcName, request.fileName, request.lineNumber, callbackId);
+            }
+#if !defined(__EMSCRIPTEN__)
+            if (request.onClosed) request.onClosed();
+#endif
+            if (request.done != nullptr) request.done->set_value();
+        }
+
+        /// @brief ダイアログを表示する専用スレッドを起動する。m_Mutex を保持した状態で呼ぶ
+        void StartWorker()
+        {
+#if defined(DEBUG_PRINT_POPUP_THREAD)
+            if (m_Worker.joinable()) return;
+            m_Worker = std::thread([this]
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                while (true)
+                {
+                    m_Condition.wait(lock, [this] { return m_Stop || !m_Requests.empty(); });
+                    if (m_Requests.empty()) break;
+
+                    PopupRequest request = std::move(m_Requests.front());
+                    m_Requests.pop_front();
+
+                    // ダイアログを表示している間も要求を受け付けられるようにロックを外す
+                    lock.unlock();
+                    Show(request);
+                    lock.lock();
+                }
+            });
+#endif
+        }
+
+        std::mutex               m_Mutex;      // 全メンバーの排他制御用
+        std::condition_variable  m_Condition;  // 専用スレッドの起床用
+#if defined(DEBUG_PRINT_POPUP_THREAD)
+        std::thread              m_Worker;     // ダイアログを1件ずつ表示する専用スレッド
+#endif
+        std::deque<PopupRequest> m_Requests;   // 表示待ちの要求
+        std::deque<std::chrono::steady_clock::time_point> m_DialogTimes;  // 直近1分間に表示したダイアログの時刻
+        bool                     m_Stop = false;  // 専用スレッドの終了要求
+    };
+
+    /// @brief POPUP_MESSAGE マクロから呼び出されるポップアップ表示処理。
+    /// Config の POPUP_MESSAGE 用の色でコンソールに表示し、ポップアップを表示する。
+    /// ファイル名・行番号などの詳細情報は表示しない。表示を待たずに戻り、アプリは継続する
+    /// @param message 表示するメッセージ
+    /// @param icon アイコン種別
+    inline void ShowPopupMessage(const std::string& message, PopupIcon icon)
+    {
+        PopupQueue::GetInstance().Enqueue({ message, icon });
+    }
+
+    /// @brief POPUP_MESSAGE_BLOCKING マクロから呼び出されるポップアップ表示処理。
+    /// ShowPopupMessage と同じ内容を表示し、ダイアログが閉じられるまで待機する
+    /// @param message 表示するメッセージ
+    /// @param icon アイコン種別
+    inline void ShowPopupMessageBlocking(const std::string& message, PopupIcon icon)
+    {
+        PopupQueue::GetInstance().ShowAndWait({ message, icon });
+    }
+
+    /// @brief POPUP_MESSAGE_CALLBACK マクロから呼び出されるポップアップ表示処理。
+    /// ShowPopupMessage と同じ内容を表示し、待機せずに戻る。ダイアログが閉じられた後に onClosed を呼び出す。
+    /// ネイティブ環境ではダイアログを表示する専用スレッドから、Emscripten ではブラウザのイベントから呼び出される。
+    /// ダイアログを開かずにコンソールに表示した場合はすぐに呼び出す
+    /// @param message 表示するメッセージ
+    /// @param icon アイコン種別
+    /// @param onClosed ダイアログが閉じられた後に呼び出す関数
+    inline void ShowPopupMessageCallback(const std::string& message, PopupIcon icon, std::function<void()> onClosed)
+    {
+        PopupRequest request{ message, icon };
+        request.onClosed = std::move(onClosed);
+        PopupQueue::GetInstance().Enqueue(std::move(request));
+    }
+
+    /// @brief POPUP_WARNING_MESSAGE マクロから呼び出される警告ポップアップ表示処理。
+    /// Config の POPUP_WARNING_MESSAGE 用の色でコンソールに表示し、
+    /// 警告アイコン付きポップアップにファイル名・行番号・関数名も含めて表示する。
+    /// blocking が true の場合のみダイアログが閉じられるまで待機する。アプリは継続する
+    /// @param message 警告メッセージ
+    /// @param funcName 呼び出し元の関数名
+    /// @param fileName 呼び出し元のファイル名
+    /// @param lineNumber 呼び出し元の行番号
+    /// @param blocking ダイアログが閉じられるまで待機する場合は true
+    inline void ShowPopupWarningMessage(
+        const std::string& message,
+        const char* funcName,
+        const char* fileName,
+        int lineNumber,
+        bool blocking = false)
+    {
+        PopupRequest request{ message, PopupIcon::Warning, funcName, fileName, lineNumber };
+        if (blocking)
+        {
+            PopupQueue::GetInstance().ShowAndWait(std::move(request));
+        }
+        else
+        {
+            PopupQueue::GetInstance().Enqueue(std::move(request));
+        }
+    }
+
+    /// @brief POPUP_ERROR_MESSAGE マクロから呼び出されるエラーポップアップ表示処理。
+    /// Config の POPUP_ERROR_MESSAGE 用の色でコンソールに表示し、
+    /// エラーアイコン付きポップアップにファイル名・行番号・関数名も含めて表示する。
+    /// IsExitOnError() が true の場合はダイアログが閉じられるまで待ってからアプリを終了する。
+    /// それ以外は blocking が true の場合のみ待機する
+    /// @param message エラーメッセージ
+    /// @param funcName 呼び出し元の関数名
+    /// @param fileName 呼び出し元のファイル名
+    /// @param lineNumber 呼び出し元の行番号
+    /// @param blocking ダイアログが閉じられるまで待機する場合は true
+    inline void ShowPopupErrorMessage(
+        const std::string& message,
+        const char* funcName,
+        const char* fileName,
+        int lineNumber,
+        bool blocking = false)
+    {
+        const bool exitOnError = DebugPrintConfig::GetInstance().IsExitOnError();
+        PopupRequest request{ message, PopupIcon::Error, funcName, fileName, lineNumber };
+        if (blocking || exitOnError)
+        {
+            PopupQueue::GetInstance().ShowAndWait(std::move(request));
+        }
+        else
+        {
+            PopupQueue::GetInstance().Enqueue(std::move(request));
+        }
+
+        // エラー時の強制終了フラグが立っていたら終了させる
+        if (exitOnError)
+        {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+} // namespace DebugPrint
+
+#if defined(__EMSCRIPTEN__)
+/// @brief SweetAlert2 のダイアログが閉じられたときに JavaScript(js_show_popup)から呼び出される
+/// @param id PopupCallbacks::Register で得た番号
+extern "C" EMSCRIPTEN_KEEPALIVE inline void DebugPrintPopupClosed(uint32_t id)
+{
+    DebugPrint::PopupCallbacks::GetInstance().Invoke(id);
+}
+#endif
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <cstdlib>
+#include <mutex>
 
 
 #ifndef __EMSCRIPTEN__
@@ -14,8 +16,9 @@
     #endif
     #include "../third_party/tinyfiledialogs/tinyfiledialogs.h"
 #else
-    // Emscripten 環境用の JavaScript 関数定義を読み込む
+    // Emscripten 環境用の JavaScript 関数定義と、出力を溜めるリングバッファを読み込む
     #include "EmscriptenFunctions.h"
+    #include "WebOutputRing.h"
 #endif
 
 
@@ -23,6 +26,7 @@
 #include "ColorDefine.h"
 #include "TemplateStrings.h"
 #include "DebugPrintConfig.h"
+#include "DuplicateFilter.h"
 
 namespace DebugPrint
 {
@@ -51,63 +55,61 @@ namespace DebugPrint
         }
     }
 
-    /// @brief メッセージを標準出力に表示する基本関数。
-    /// 指定色でメッセージを表示する
+    /// @brief 標準出力・標準エラー出力への書き込みを排他制御するミューテックスを取得する。
+    /// 色の切り替えとメッセージ本文が他スレッドの出力と混ざらないようにする
+    inline std::mutex& GetOutputMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    /// @brief メッセージをそのまま標準出力または標準エラー出力に書き込む。
+    /// 指定色でメッセージを表示する。色の切り替えを含めて1つのまとまりとして出力する。
+    /// 同じメッセージの連続の省略は行わない
     /// @param message 表示するメッセージ
     /// @param color 表示色
-    inline void PrintMessage(const std::string& message, Color color = PRINT_COLOR::DEFAULT)
+    /// @param toStderr 標準エラー出力に書き込む場合は true
+    inline void WriteOutput(const std::string& message, Color color, bool toStderr)
     {
 #if defined(__EMSCRIPTEN__)
 
-        if (DebugPrintConfig::GetInstance().IsColorOutputEnabled())
-        {
-            js_print(message.c_str(), color);
-        }
-        else
-        {
-            js_print(message.c_str(), PRINT_COLOR::DEFAULT);
-        }
+        const Color outputColor = DebugPrintConfig::GetInstance().IsColorOutputEnabled() ? color : PRINT_COLOR::DEFAULT;
+        WebOutputRing::GetInstance().Write(message, outputColor, toStderr);
 
 #else
+        std::ostream& stream = toStderr ? std::cerr : std::cout;
+        std::lock_guard<std::mutex> lock(GetOutputMutex());
         if (DebugPrintConfig::GetInstance().IsColorOutputEnabled())
         {
-            std::cout << MakeColorCode(color) << message << MakeColorCode(PRINT_COLOR::DEFAULT) << std::flush;
+            stream << MakeColorCode(color) << message << MakeColorCode(PRINT_COLOR::DEFAULT) << std::flush;
         }
         else
         {
-            std::cout << message << std::flush;
+            stream << message << std::flush;
         }
 #endif
     }
 
+    /// @brief メッセージを標準出力に表示する基本関数。
+    /// 指定色でメッセージを表示する。色の切り替えを含めて1つのまとまりとして出力する。
+    /// 直前と同じメッセージは出力せず、繰り返し回数のみを後でまとめて表示する
+    /// @param message 表示するメッセージ
+    /// @param color 表示色
+    inline void PrintMessage(const std::string& message, Color color = PRINT_COLOR::DEFAULT)
+    {
+        if (DuplicateFilter::GetInstance().Filter(message, color, false)) return;
+        WriteOutput(message, color, false);
+    }
+
     /// @brief メッセージを標準エラー出力に表示する基本関数。
-    /// 指定色でメッセージを表示する
+    /// 指定色でメッセージを表示する。色の切り替えを含めて1つのまとまりとして出力する。
+    /// 直前と同じメッセージは出力せず、繰り返し回数のみを後でまとめて表示する
     /// @param message 表示するメッセージ
     /// @param color 表示色
     inline void PrintErrorMessage(const std::string& message, Color color = PRINT_COLOR::DEFAULT)
     {
-#if defined(__EMSCRIPTEN__)
-
-        if (DebugPrintConfig::GetInstance().IsColorOutputEnabled())
-        {
-            js_print_error(message.c_str(), color);
-        }
-        else
-        {
-            js_print_error(message.c_str(), PRINT_COLOR::DEFAULT);
-        }
-
-
-#else
-        if (DebugPrintConfig::GetInstance().IsColorOutputEnabled())
-        {
-            std::cerr << MakeColorCode(color) << message << MakeColorCode(PRINT_COLOR::DEFAULT) << std::flush;
-        }
-        else
-        {
-            std::cerr << message << std::flush;
-        }
-#endif
+        if (DuplicateFilter::GetInstance().Filter(message, color, true)) return;
+        WriteOutput(message, color, true);
     }
 
     /// @brief エラー・警告情報を標準エラー出力に表示する内部共通処理。
@@ -134,24 +136,46 @@ namespace DebugPrint
         PrintErrorMessage(out.str(), color);
     }
 
+    /// @brief ポップアップのダイアログを表示できる環境かどうかを判定する。
+    /// Emscripten ではブラウザの SweetAlert2 を使うため常に表示できるものとする。
+    /// それ以外は tinyfiledialogs に "tinyfd_query" を渡し、グラフィカルなダイアログを使えるかを問い合わせる。
+    /// ディスプレイのない Linux では補助プログラムを探すプロセスも起動しないよう、先に環境変数で判定する。
+    /// DebugPrintConfig::IsPopupAvailable() から1度だけ呼び出される
+    /// @return ダイアログを表示できる場合は true
+    inline bool DetectPopupAvailable()
+    {
+#if defined(__EMSCRIPTEN__)
+        return true;
+#else
+#if !defined(_WIN32) && !defined(__APPLE__)
+        if (std::getenv("DISPLAY") == nullptr && std::getenv("WAYLAND_DISPLAY") == nullptr) return false;
+#endif
+        return tinyfd_messageBox("tinyfd_query", "", "ok", "info", 1) == 1;
+#endif
+    }
+
     /// @brief ポップアップダイアログを表示する内部共通処理。
     /// Emscripten ではブラウザの SweetAlert2 を使用したモーダルダイアログを表示し、
     /// それ以外は tinyfiledialogs を使用する。
     /// ファイル名・関数名が渡された場合はダイアログ内の詳細情報欄にも表示する。
-    /// SweetAlert2 の Swal.fire() は Promise を返すため、C++ 側はダイアログの
-    /// 閉じるのを待たずに即リターンする（-sASYNCIFY 不要）。
-    /// Node.js 環境では SweetAlert2 が使えないため stderr に出力してフォールバックする
+    /// SweetAlert2 の Swal.fire() が返す Promise は待たないため、C++ 側はダイアログが
+    /// 閉じられるのを待たずに即リターンする（-sASYNCIFY 不要）。
+    /// 閉じられた後の処理は callbackId で登録した関数を JavaScript 側から呼び出す。
+    /// Node.js 環境では SweetAlert2 が使えないため stderr に出力してフォールバックする。
+    /// tinyfiledialogs はダイアログが閉じられるまで戻らないため、通常は PopupQueue の専用スレッドから呼び出される
     /// @param message 表示するメッセージ
     /// @param icon アイコン種別
     /// @param funcName 呼び出し元の関数名。nullptr の場合は詳細情報を表示しない
     /// @param fileName 呼び出し元のファイル名。nullptr の場合は詳細情報を表示しない
     /// @param lineNumber 呼び出し元の行番号
+    /// @param callbackId Emscripten でダイアログが閉じられた後に呼び出す関数の番号(PopupCallbacks で登録する。0 で呼び出さない)
     inline void ShowPopup(
         const std::string& message,
         PopupIcon icon,
-        const char* funcName  = nullptr,
-        const char* fileName  = nullptr,
-        int         lineNumber = 0)
+        const char* funcName   = nullptr,
+        const char* fileName   = nullptr,
+        int         lineNumber = 0,
+        uint32_t    callbackId = 0)
     {
 #if defined(__EMSCRIPTEN__)
         // ファイル名・行番号・関数名の情報を HTML 形式で組み立てる。
@@ -169,10 +193,11 @@ namespace DebugPrint
         const std::string htmlDetail = detail.str();
 
 
-        js_show_popup(message.c_str(), PopupIconToString(icon), htmlDetail.c_str());
+        js_show_popup(message.c_str(), PopupIconToString(icon), htmlDetail.c_str(), callbackId);
 
 
 #else
+        (void)callbackId;
         tinyfd_messageBox(
             errorDialogTitle().c_str(),
             message.c_str(),
@@ -221,53 +246,4 @@ namespace DebugPrint
         }
     }
 
-    /// @brief POPUP_MESSAGE マクロから呼び出されるポップアップ表示処理。
-    /// Config の POPUP_MESSAGE 用の色でコンソールに表示し、ポップアップを表示する。
-    /// ファイル名・行番号などの詳細情報は表示しない。アプリは継続する
-    /// @param message 表示するメッセージ
-    /// @param icon アイコン種別
-    inline void ShowPopupMessage(const std::string& message, PopupIcon icon)
-    {
-        ShowPopup(message, icon);
-    }
-
-    /// @brief POPUP_WARNING_MESSAGE マクロから呼び出される警告ポップアップ表示処理。
-    /// Config の POPUP_WARNING_MESSAGE 用の色でコンソールに表示し、
-    /// 警告アイコン付きポップアップにファイル名・行番号・関数名も含めて表示する。アプリは継続する
-    /// @param message 警告メッセージ
-    /// @param funcName 呼び出し元の関数名
-    /// @param fileName 呼び出し元のファイル名
-    /// @param lineNumber 呼び出し元の行番号
-    inline void ShowPopupWarningMessage(
-        const std::string& message,
-        const char* funcName,
-        const char* fileName,
-        int lineNumber)
-    {
-        ShowPopup(message, PopupIcon::Warning, funcName, fileName, lineNumber);
-    }
-
-    /// @brief POPUP_ERROR_MESSAGE マクロから呼び出されるエラーポップアップ表示処理。
-    /// Config の POPUP_ERROR_MESSAGE 用の色でコンソールに表示し、
-    /// エラーアイコン付きポップアップにファイル名・行番号・関数名も含めて表示する。
-    /// IsExitOnError() が true の場合はアプリを終了する
-    /// @param message エラーメッセージ
-    /// @param funcName 呼び出し元の関数名
-    /// @param fileName 呼び出し元のファイル名
-    /// @param lineNumber 呼び出し元の行番号
-    inline void ShowPopupErrorMessage(
-        const std::string& message,
-        const char* funcName,
-        const char* fileName,
-        int lineNumber)
-    {
-        ShowPopup(message, PopupIcon::Error, funcName, fileName, lineNumber);
-
-        // エラー時の強制終了フラグが立っていたら終了させる
-        if (DebugPrintConfig::GetInstance().IsExitOnError())
-        {
-            std::exit(EXIT_FAILURE);
-        }
-    }
-
 } // namespace DebugPrint
\ No newline at end of file
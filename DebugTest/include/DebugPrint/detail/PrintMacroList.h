@@ -2,32 +2,146 @@
 #include <cstdlib>
 #include "MacroList.h"
 #include "PrintVariable.h"
+#include "NumericSummary.h"
+#include "MemoryDump.h"
+#include "WatchRegistry.h"
 #include "PrintStruct.h"
+#include "StructJson.h"
 #include "PrintFunction.h"
+#include "PopupQueue.h"
 #include "PrintTracer.h"
+#include "RateLimit.h"
 
 // 変数表示マクロ
 #define PRINT_VARIABLE(variable) \
     DebugPrint::PrintVariable(#variable, variable)
 
+// 数値の配列の要素数と要約統計(最小値・最大値・平均・標準偏差・NaN と無限大の数・分布)を表示するマクロ
+#define PRINT_VARIABLE_SUMMARY(variable) \
+    DebugPrint::PrintVariableSummary(#variable, variable)
+
 // 構造体のメンバーを表示するマクロ
 #define PRINT_STRUCT(variable) \
     DebugPrint::PrintStruct(#variable, variable)
 
-// メッセージ表示マクロ
+// 構造体を前回の呼び出し時と比較し、変化したメンバーのみを前後の値とともに表示するマクロ。
+// 前回の値は呼び出し箇所ごとに保持され、変化がない場合は何も表示しない
+#define PRINT_STRUCT_DIFF(variable) \
+    do \
+    { \
+        static DebugPrint::StructSnapshot<std::remove_cvref_t<decltype(variable)>> _structSnapshot; \
+        DebugPrint::PrintStructDiff(#variable, variable, _structSnapshot); \
+    } while (0)
+
+// 構造体を1行の JSON で表示するマクロ。ネストした構造体・列挙型・コンテナも JSON の値として書き出す
+#define PRINT_STRUCT_JSON(variable) \
+    DebugPrint::PrintStructJson(#variable, variable)
+
+// 変数を監視対象に登録するマクロ。DEBUG_WATCH_TICK のたびに前回から変化していれば表示する。
+// 同じ変数を何度登録しても1つとして扱う
+#define PRINT_WATCH(variable) \
+    DebugPrint::WatchRegistry::GetInstance().Watch(#variable, variable)
+
+// メモリの内容を16進数と ASCII で表示するマクロ(hexdump -C と同じ形式)
+#define PRINT_MEMORY(address, size) \
+    DebugPrint::PrintMemory(#address, address, size)
+
+// 呼び出し箇所ごとの出力量の制限を static 変数として置き、1秒あたりのメッセージ数・バイト数の上限内の場合のみ
+// print を実行する内部マクロ。メッセージ数が上限を超えている間はメッセージの式を評価しない。
+// force が真の場合(終了するエラーなど)は上限に関わらず実行する。
+// 従来どおり式として使える(条件演算子やカンマ演算子の中に書ける)よう、状態はキャプチャを持たないラムダ式
+// (名前空間スコープの変数の初期化式にも書ける)の static 変数として取得し、条件演算子で表示を選ぶ。
+// メッセージ数の判定を通った回は CallSiteThrottle::Current() で状態を参照する。
+// print は CallSiteThrottle::PrintFunction に変換できる表示関数
+#define DEBUG_PRINT_THROTTLED(force, message, print) \
+    (([](const char* _throttleFuncName, const char* _throttleFileName, int _throttleLineNumber) -> DebugPrint::CallSiteThrottle& \
+    { \
+        static DebugPrint::CallSiteThrottle _callSiteThrottle(_throttleFuncName, _throttleFileName, _throttleLineNumber); \
+        return _callSiteThrottle; \
+    }(THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER).AdmitMessage() || (force)) \
+        ? DebugPrint::CallSiteThrottle::Current().Emit(message, (force), print, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER) \
+        : void())
+
+// メッセージ表示マクロ。出力量が上限を超えた呼び出し箇所は自動で間引かれる
 #define PRINT_MESSAGE(message) \
-    DebugPrint::PrintMessage(message)
+    DEBUG_PRINT_THROTTLED(false, message, \
+        [](const std::string& _message, const char*, const char*, int) { DebugPrint::PrintMessage(_message); })
 
-// 警告メッセージ表示マクロ。コンソールに警告情報を表示する。アプリは継続する
+// 警告メッセージ表示マクロ。コンソールに警告情報を表示する。アプリは継続する。
+// 出力量が上限を超えた呼び出し箇所は自動で間引かれる
 #define PRINT_WARNING_MESSAGE(message) \
-    DebugPrint::PrintAppWarningMessage(message, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER)
+    DEBUG_PRINT_THROTTLED(false, message, &DebugPrint::PrintAppWarningMessage)
 
 // エラーメッセージ表示マクロ。コンソールにエラー情報を表示する。
-// DebugPrintConfig::SetExitOnError(true) の場合はアプリを終了する
+// DebugPrintConfig::SetExitOnError(true) の場合はアプリを終了する(この場合は間引かない)。
+// 出力量が上限を超えた呼び出し箇所は自動で間引かれる
 #define PRINT_ERROR_MESSAGE(message) \
-    DebugPrint::PrintAppErrorMessage(message, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER)
+    DEBUG_PRINT_THROTTLED(DebugPrint::DebugPrintConfig::GetInstance().IsExitOnError(), message, &DebugPrint::PrintAppErrorMessage)
+
+// 呼び出し箇所ごとの間引きの状態を static 変数として置き、shouldPrint が真の回だけ print を実行する内部マクロ。
+// 抑制する回はメッセージの式を評価しないため、書式化の処理も行わない。
+// PRINT_MESSAGE と同じく式として使えるよう、状態はキャプチャを持たないラムダ式(名前空間スコープでも書ける)の
+// static 変数として取得し、条件演算子で print を選ぶ。出力する回は CallSiteLimiter::Current() で状態を参照する
+#define DEBUG_PRINT_LIMITED(shouldPrint, print) \
+    ([](const char* _limiterFuncName, const char* _limiterFileName, int _limiterLineNumber) -> DebugPrint::CallSiteLimiter& \
+    { \
+        static DebugPrint::CallSiteLimiter _callSiteLimiter(_limiterFuncName, _limiterFileName, _limiterLineNumber); \
+        return _callSiteLimiter; \
+    }(THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER).shouldPrint ? (print) : void())
+
+// 間引いて表示したメッセージに、前回の表示以降に抑制した回数を付け加える内部マクロ。
+// メッセージの式より先に呼び出し箇所を取得するよう、メンバー関数の呼び出しにする(メッセージの中で別の間引きマクロが使われても取り違えない)
+#define DEBUG_PRINT_WITH_SUPPRESSED(message) \
+    DebugPrint::CallSiteLimiter::Current().WithSuppressedCount(message)
+
+// 呼び出し箇所ごとに最初の1回だけ表示するメッセージ表示マクロ。2回目以降の回数は DEBUG_PRINT_SUPPRESSED_SUMMARY で表示する
+#define PRINT_MESSAGE_ONCE(message) \
+    DEBUG_PRINT_LIMITED(Once(), DebugPrint::PrintMessage(DEBUG_PRINT_WITH_SUPPRESSED(message)))
+
+// 呼び出し箇所ごとに n 回に1回だけ表示するメッセージ表示マクロ。抑制した回数をメッセージに付け加える
+#define PRINT_MESSAGE_EVERY_N(n, message) \
+    DEBUG_PRINT_LIMITED(EveryN(n), DebugPrint::PrintMessage(DEBUG_PRINT_WITH_SUPPRESSED(message)))
+
+// 呼び出し箇所ごとに ms ミリ秒に1回だけ表示するメッセージ表示マクロ。抑制した回数をメッセージに付け加える
+#define PRINT_MESSAGE_EVERY_MS(ms, message) \
+    DEBUG_PRINT_LIMITED(EveryMs(ms), DebugPrint::PrintMessage(DEBUG_PRINT_WITH_SUPPRESSED(message)))
+
+// 呼び出し箇所ごとに最初の1回だけ表示する警告メッセージ表示マクロ
+#define PRINT_WARNING_MESSAGE_ONCE(message) \
+    DEBUG_PRINT_LIMITED(Once(), DebugPrint::PrintAppWarningMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
+
+// 呼び出し箇所ごとに n 回に1回だけ表示する警告メッセージ表示マクロ
+#define PRINT_WARNING_MESSAGE_EVERY_N(n, message) \
+    DEBUG_PRINT_LIMITED(EveryN(n), DebugPrint::PrintAppWarningMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
 
-// ポップアップ表示マクロ。コンソールとポップアップにメッセージを表示する。アプリは継続する
+// 呼び出し箇所ごとに ms ミリ秒に1回だけ表示する警告メッセージ表示マクロ
+#define PRINT_WARNING_MESSAGE_EVERY_MS(ms, message) \
+    DEBUG_PRINT_LIMITED(EveryMs(ms), DebugPrint::PrintAppWarningMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
+
+// 呼び出し箇所ごとに最初の1回だけ表示するエラーメッセージ表示マクロ
+#define PRINT_ERROR_MESSAGE_ONCE(message) \
+    DEBUG_PRINT_LIMITED(Once(), DebugPrint::PrintAppErrorMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
+
+// 呼び出し箇所ごとに n 回に1回だけ表示するエラーメッセージ表示マクロ
+#define PRINT_ERROR_MESSAGE_EVERY_N(n, message) \
+    DEBUG_PRINT_LIMITED(EveryN(n), DebugPrint::PrintAppErrorMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
+
+// 呼び出し箇所ごとに ms ミリ秒に1回だけ表示するエラーメッセージ表示マクロ
+#define PRINT_ERROR_MESSAGE_EVERY_MS(ms, message) \
+    DEBUG_PRINT_LIMITED(EveryMs(ms), DebugPrint::PrintAppErrorMessage(DEBUG_PRINT_WITH_SUPPRESSED(message), THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER))
+
+// 出力量の上限を超えて間引かれた回数の多い呼び出し箇所を表示するマクロ。
+// 間引きが続いている間は DEBUG_SET_THROTTLE_REPORT_MS の間隔で自動的にも表示される
+#define DEBUG_PRINT_THROTTLE_REPORT() \
+    DebugPrint::ThrottleRegistry::GetInstance().Report()
+
+// 間引きマクロで前回の表示以降に抑制した回数を呼び出し箇所ごとに表示するマクロ。
+// 定期的に呼び出すと抑制された出力の件数を把握できる。プログラム終了時にも残りが表示される
+#define DEBUG_PRINT_SUPPRESSED_SUMMARY() \
+    DebugPrint::SuppressionRegistry::GetInstance().Report()
+
+// ポップアップ表示マクロ。コンソールとポップアップにメッセージを表示する。
+// ダイアログは専用スレッドが表示するため、閉じられるのを待たずに戻る。アプリは継続する
 #define POPUP_MESSAGE(message) \
     DebugPrint::ShowPopupMessage(message, DebugPrint::PopupIcon::None)
 
@@ -44,6 +158,32 @@
 #define POPUP_ERROR_MESSAGE(message) \
     DebugPrint::ShowPopupErrorMessage(message, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER)
 
+// ポップアップを表示し、ダイアログが閉じられた後に onClosed(引数なしの呼び出し可能オブジェクト)を呼び出すマクロ。
+// 待機せずに戻るため、Emscripten でも -sASYNCIFY なしで閉じられた後の処理を行える
+#define POPUP_MESSAGE_CALLBACK(message, onClosed) \
+    DebugPrint::ShowPopupMessageCallback(message, DebugPrint::PopupIcon::None, onClosed)
+
+// ダイアログが閉じられた後に onClosed を呼び出すポップアップ表示マクロ(アイコン指定版)
+#define POPUP_MESSAGE_ICON_CALLBACK(message, icon, onClosed) \
+    DebugPrint::ShowPopupMessageCallback(message, icon, onClosed)
+
+// 確認が必要な場面向けに、ダイアログが閉じられるまで待機するポップアップ表示マクロ。
+// Emscripten では待機できないため表示して即座に戻る(閉じられた後の処理は POPUP_MESSAGE_CALLBACK を使う)
+#define POPUP_MESSAGE_BLOCKING(message) \
+    DebugPrint::ShowPopupMessageBlocking(message, DebugPrint::PopupIcon::None)
+
+// ダイアログが閉じられるまで待機するポップアップ表示マクロ(アイコン指定版)
+#define POPUP_MESSAGE_ICON_BLOCKING(message, icon) \
+    DebugPrint::ShowPopupMessageBlocking(message, icon)
+
+// ダイアログが閉じられるまで待機する警告ポップアップ表示マクロ
+#define POPUP_WARNING_MESSAGE_BLOCKING(message) \
+    DebugPrint::ShowPopupWarningMessage(message, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER, true)
+
+// ダイアログが閉じられるまで待機するエラーポップアップ表示マクロ
+#define POPUP_ERROR_MESSAGE_BLOCKING(message) \
+    DebugPrint::ShowPopupErrorMessage(message, THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER, true)
+
 
 // ===== Config 設定マクロ =====
 
@@ -63,6 +203,30 @@
 #define DEBUG_SET_LOG_PATH(path) \
     DebugPrint::DebugPrintConfig::GetInstance().SetLogPath(path)
 
+// 同じメッセージが連続したときに2回目以降を省略し、繰り返し回数のみを表示するかを設定するマクロ
+#define DEBUG_SET_COLLAPSE_DUPLICATES(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetCollapseDuplicates(enabled)
+
+// 同じメッセージが続いている間、繰り返し回数を表示する間隔(ミリ秒)を設定するマクロ
+#define DEBUG_SET_DUPLICATE_FLUSH_MS(ms) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetDuplicateFlushMs(ms)
+
+// PRINT_MESSAGE・PRINT_WARNING_MESSAGE・PRINT_ERROR_MESSAGE の呼び出し箇所ごとの1秒あたりの最大メッセージ数を設定するマクロ(0 で制限しない)
+#define DEBUG_SET_THROTTLE_MESSAGES_PER_SEC(messagesPerSec) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetThrottleMessagesPerSec(messagesPerSec)
+
+// PRINT_MESSAGE・PRINT_WARNING_MESSAGE・PRINT_ERROR_MESSAGE の呼び出し箇所ごとの1秒あたりの最大バイト数を設定するマクロ(0 で制限しない)
+#define DEBUG_SET_THROTTLE_BYTES_PER_SEC(bytesPerSec) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetThrottleBytesPerSec(bytesPerSec)
+
+// 間引かれた呼び出し箇所を自動で表示する間隔(ミリ秒)を設定するマクロ
+#define DEBUG_SET_THROTTLE_REPORT_MS(ms) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetThrottleReportMs(ms)
+
+// 1分あたりに表示するポップアップの最大数を設定するマクロ(0 で制限しない)。超えた分はコンソールにのみ表示する
+#define DEBUG_SET_POPUP_MAX_PER_MINUTE(dialogsPerMinute) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetPopupMaxPerMinute(dialogsPerMinute)
+
 // エラー系マクロ呼び出し時の終了有無を設定するマクロ
 #define DEBUG_SET_EXIT_ON_ERROR(enabled) \
     DebugPrint::DebugPrintConfig::GetInstance().SetExitOnError(enabled)
@@ -91,6 +255,71 @@
 #define DEBUG_SET_POPUP_ERROR_MESSAGE_COLOR(color) \
     DebugPrint::DebugPrintConfig::GetInstance().SetPopupErrorMessageColor(color)
 
+// PRINT_TRACE_CLASS で生成・破棄のたびにメッセージを出力するかを設定するマクロ
+#define DEBUG_SET_TRACE_CLASS_EVENTS(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetTraceClassEvents(enabled)
+
+// PRINT_TRACE_CLASS でインスタンスごとの寿命を計測し、終了時に寿命ヒストグラムを出力するかを設定するマクロ
+#define DEBUG_SET_TRACE_CLASS_LIFETIME(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetTraceClassLifetime(enabled)
+
+// プログラム終了時に PRINT_TRACE_FUNCTION の呼び出し箇所ごとの集計を出力するかを設定するマクロ
+#define DEBUG_SET_SCOPE_PROFILE_REPORT(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetScopeProfileReport(enabled)
+
+// PRINT_TRACE_FUNCTION の呼び出し箇所ごとの集計(回数・時間・ヒープ確保)を出力するマクロ
+#define DEBUG_PRINT_SCOPE_PROFILE() \
+    DebugPrint::ScopeProfiler::GetInstance().Report()
+
+// PRINT_TRACE_FUNCTION でパフォーマンスカウンタ(サイクル数・IPC・キャッシュミスなど)を計測するかを設定するマクロ
+#define DEBUG_SET_PERF_COUNTERS(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetPerfCounters(enabled)
+
+// PRINT_TRACE_FUNCTION のスコープをフレームグラフ用に集計するかを設定するマクロ
+#define DEBUG_SET_FLAME_GRAPH(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetFlameGraph(enabled)
+
+// PRINT_TRACE_FUNCTION のスコープをテキストの代わりに User Timing(performance.measure)で記録するかを設定するマクロ。
+// ブラウザの開発者ツールのパフォーマンスパネルや Node.js の perf_hooks で確認できる(Emscripten のみ)
+#define DEBUG_SET_USER_TIMING(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetUserTiming(enabled)
+
+// フレームグラフ用の折り畳みスタック("main;update;physics 1234")をファイルに書き出すマクロ
+#define DEBUG_WRITE_FLAME_GRAPH(path) \
+    DebugPrint::FlameGraphCollector::GetInstance().WriteToFile(path)
+
+// PRINT_VARIABLE・PRINT_STRUCT でコンテナ1つにつき表示する最大要素数を設定するマクロ
+#define DEBUG_SET_PRINT_MAX_ELEMENTS(count) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetPrintMaxElements(count)
+
+// PRINT_VARIABLE・PRINT_STRUCT で入れ子のコンテナを展開する最大の深さを設定するマクロ
+#define DEBUG_SET_PRINT_MAX_DEPTH(depth) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetPrintMaxDepth(depth)
+
+// PRINT_VARIABLE で数値の配列を表示するときに1行に並べる要素数を設定するマクロ
+#define DEBUG_SET_PRINT_COLUMNS(columns) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetPrintColumns(columns)
+
+// PRINT_MEMORY で表示する最大バイト数を設定するマクロ
+#define DEBUG_SET_MEMORY_DUMP_MAX_BYTES(bytes) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetMemoryDumpMaxBytes(bytes)
+
+// PRINT_MEMORY で直前の行と同じ内容の行を "*" にまとめるかを設定するマクロ
+#define DEBUG_SET_MEMORY_DUMP_COLLAPSE(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetMemoryDumpCollapse(enabled)
+
+// 監視中の全変数を前回の値と比較し、変化した変数を表示するマクロ。1フレームに1回呼び出す
+#define DEBUG_WATCH_TICK() \
+    DebugPrint::WatchRegistry::GetInstance().Tick()
+
+// 変数の監視を解除するマクロ。スコープを抜ける変数は破棄される前に解除する
+#define DEBUG_UNWATCH(variable) \
+    DebugPrint::WatchRegistry::GetInstance().Unwatch(variable)
+
+// 全変数の監視を解除するマクロ
+#define DEBUG_CLEAR_WATCH() \
+    DebugPrint::WatchRegistry::GetInstance().Clear()
+
 // ログエントリをファイルに書き出すマクロ。パスを指定して書き出す
 #define DEBUG_WRITE_LOG(path) \
     DebugPrint::LogWriter::GetInstance().WriteToFile(path)
@@ -99,11 +328,40 @@
 #define DEBUG_CLEAR_LOG() \
     DebugPrint::LogWriter::GetInstance().Clear()
 
+// PRINT_STRUCT の記録モードを設定するマクロ。有効な場合、トリビアルにコピー可能な構造体は
+// 表示せずにバイト列のまま記録し、DEBUG_WRITE_STRUCT_CAPTURE でスキーマとともにファイルに書き出す
+#define DEBUG_SET_STRUCT_CAPTURE(enabled) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetStructCapture(enabled)
+
+// 構造体の記録を蓄積する最大バイト数を設定するマクロ。上限に達した後の記録は破棄する(0 で制限しない)
+#define DEBUG_SET_STRUCT_CAPTURE_MAX_BYTES(bytes) \
+    DebugPrint::DebugPrintConfig::GetInstance().SetStructCaptureMaxBytes(bytes)
+
+// 記録した構造体をファイルに書き出すマクロ。書き出したファイルのパスを返す(失敗した場合は空文字列)
+#define DEBUG_WRITE_STRUCT_CAPTURE(path) \
+    DebugPrint::StructCapture::GetInstance().WriteToFile(path)
+
+// 記録した構造体をすべて消去するマクロ
+#define DEBUG_CLEAR_STRUCT_CAPTURE() \
+    DebugPrint::StructCapture::GetInstance().Clear()
+
+// 記録ファイルを復元して PRINT_STRUCT と同じ書式で表示するマクロ
+#define PRINT_STRUCT_CAPTURE_FILE(filePath) \
+    DebugPrint::PrintStructCapture(filePath)
+
 // 関数の導入から終了までを出力するマクロ
 #define PRINT_TRACE_FUNCTION                DebugPrint::FunctionTracer _funcInfo(THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER)
 #define PRINT_TRACE_FUNCTION_COLOR(color)   DebugPrint::FunctionTracer _funcColorInfo(THIS_FUNCTION_NAME, THIS_FILE_NAME, THIS_LINE_NUMBER, color)
 
-// クラスのコンストラクタ・デストラクタを出力するマクロ
-#define PRINT_TRACE_CLASS(name)                 DebugPrint::ClassTracer _classTracer{#name}
-#define PRINT_TRACE_CLASS_COLOR(name, color)    DebugPrint::ClassTracer _classColorTracer{#name, color}
+// クラスの生成・破棄を追跡するマクロ。クラスのメンバとして宣言する。
+// クラス名はタグ型の静的メンバ関数が返すため、追跡対象クラスのサイズは増えず、関数内のローカルクラスでも使える。
+// 生存数・最大生存数・累計生成数(DEBUG_SET_TRACE_CLASS_LIFETIME で有効にした場合は寿命ヒストグラムも)はプログラム終了時に出力される
+#define PRINT_TRACE_CLASS(name)                 PRINT_TRACE_CLASS_COLOR(name, PRINT_COLOR::GREEN)
+#define PRINT_TRACE_CLASS_COLOR(name, color) \
+    struct DebugPrintClassTraceTag \
+    { \
+        static constexpr const char* ClassName() { return #name; } \
+        static constexpr Color TraceColor() { return color; } \
+    }; \
+    DEBUG_PRINT_NO_UNIQUE_ADDRESS DebugPrint::ClassTracer<DebugPrintClassTraceTag> _classTracer
 
@@ -1,78 +1,159 @@
 #pragma once
+#include <cmath>
+#include <concepts>
+#include <cstring>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 #include <boost/pfr.hpp>
 #include "PrintFunction.h"
 #include "TemplateStrings.h"
 #include "PrintVariable.h"
+#include "FormatBuffer.h"
+#include "StructCapture.h"
 #include "../third_party/magic_enum/magic_enum.hpp"
 
 namespace DebugPrint
 {
     // 前方宣言
     template <typename T>
-    void PrintStructMembers(const T& var, Color color, int indent);
+    void AppendStructMembers(std::string& out, const T& var, int indent);
 
-    /// @brief Boost.PFR で扱える集成体かどうかを判定するヘルパー。
-    /// 集成体の条件: 継承なし・仮想関数なし・ユーザー定義コンストラクタなし
+    /// @brief 構造体の型ごとに、各メンバーの値の前に置く固定文字列をまとめたレイアウト。
+    /// メンバー名は Boost.PFR からコンパイル時に得られるため、
+    /// 「インデント + 変数 + 区切り + メンバー名 + 値 + 区切り」の部分は型ごとに一度だけ組み立てる。
+    /// 描画時は固定文字列のコピーと値の書式化を交互に行うだけになる。
+    /// 言語の切り替えで文字列が変わった場合は TemplateStrings の世代番号で検知して組み立て直す
     template <typename T>
-    struct is_reflectable
+    class StructLayout
     {
-        static constexpr bool value =
-            std::is_aggregate<T>::value &&
-            !is_array_like<T>::value &&
-            !std::is_array<T>::value;
-    };
+    public:
 
-    /// @brief 構造体のメンバーを再帰的に表示するヘルパー。
-    /// Boost.PFR でメンバーを走査し、メンバーが集成体の場合は再帰的に表示する。
-    /// インデントレベルに応じてスペースを挿入して階層構造を表現する
-    /// @param var 表示する構造体
-    /// @param color 表示色
-    /// @param indent 現在のインデントレベル
-    template <typename T>
-    void PrintStructMembers(const T& var, Color color, int indent)
-    {
-        // インデント用のスペース(1レベルにつき2スペース)
-        const std::string indentStr(indent * 2, ' ');
+        /// @brief 現在のスレッド用のレイアウトを取得する。
+        /// スレッドごとにキャッシュするため排他制御は不要
+        /// @param indent 先頭のインデントレベル
+        [[nodiscard]] static const StructLayout& Get(int indent)
+        {
+            thread_local StructLayout layout;
+            const uint64_t generation = TemplateStrings::GetInstance().GetGeneration();
+            if (!layout.m_Built || layout.m_Generation != generation || layout.m_Indent != indent)
+            {
+                layout.Build(indent, generation);
+            }
+            return layout;
+        }
 
-        // 全メンバー名を配列で取得する(C++20 + Boost 1.84以降)
-        constexpr auto memberNames = boost::pfr::names_as_array<T>();
+        /// @brief 指定番目の値の前に置く固定文字列を取得する。
+        /// 最後の要素は最後の値の後に置く文字列になる
+        [[nodiscard]] const std::string& Fragment(std::size_t index) const { return m_Fragments[index]; }
 
-        boost::pfr::for_each_field(var, [&]<typename Field>(const Field & field, std::size_t idx)
+    private:
+
+        /// @brief レイアウトを組み立てる
+        void Build(int indent, uint64_t generation)
         {
-            // std::string_view を std::string に変換して出力できるようにする
-            const std::string memberName(memberNames[idx]);
+            m_Fragments.clear();
+            std::string pending;
+            BuildFragments<T>(m_Fragments, pending, indent);
+            m_Fragments.push_back(std::move(pending));
 
-            std::ostringstream out;
+            m_Indent     = indent;
+            m_Generation = generation;
+            m_Built      = true;
+        }
+
+        /// @brief 型 U のメンバーを走査して固定文字列を追加する。
+        /// 集成体のメンバーは見出し行を固定文字列に含めて再帰的に展開する
+        template <typename U>
+        static void BuildFragments(std::vector<std::string>& fragments, std::string& pending, int indent)
+        {
+            constexpr auto memberNames = boost::pfr::names_as_array<U>();
+            [&]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                (BuildField<U, I>(fragments, pending, indent, memberNames[I]), ...);
+            }(std::make_index_sequence<boost::pfr::tuple_size_v<U>>{});
+        }
+
+        /// @brief 型 U の I 番目のメンバーの固定文字列を追加する
+        template <typename U, std::size_t I>
+        static void BuildField(std::vector<std::string>& fragments, std::string& pending, int indent, std::string_view memberName)
+        {
+            using Field = std::remove_cvref_t<boost::pfr::tuple_element_t<I, U>>;
+
+            pending.append(static_cast<std::size_t>(indent) * 2, ' ');
+            pending += variableString();
+            pending += pairSeparatorString();
+            pending += memberName;
 
             if constexpr (is_reflectable<Field>::value)
             {
-                out << indentStr
-                    << variableString() << pairSeparatorString() << memberName << "\n";
-                PrintMessage(out.str(), color);
-                PrintStructMembers(field, color, indent + 1);
+                pending += '\n';
+                BuildFragments<Field>(fragments, pending, indent + 1);
             }
-            else if constexpr (std::is_enum<Field>::value)
+            else
             {
-                out << indentStr
-                    << variableString() << pairSeparatorString() << memberName << "  "
-                    << valueString() << pairSeparatorString() << magic_enum::enum_name(field) << "\n";
-                PrintMessage(out.str(), color);
+                pending += "  ";
+                pending += valueString();
+                pending += pairSeparatorString();
+                fragments.push_back(std::move(pending));
+                pending.assign(1, '\n');
+            }
+        }
+
+        std::vector<std::string> m_Fragments;           // 各値の前に置く固定文字列(末尾は最後の値の後)
+        uint64_t                 m_Generation = 0;      // 組み立てたときの文字列テーブルの世代番号
+        int                      m_Indent     = 0;      // 組み立てたときのインデントレベル
+        bool                     m_Built      = false;  // 組み立て済みかどうか
+    };
+
+    /// @brief 構造体のメンバーの値をレイアウトの固定文字列と交互に書き込むヘルパー。
+    /// メンバーが集成体の場合は再帰的に書き込む。
+    /// 列挙型・コンテナ型などのメンバーは PRINT_VARIABLE と同じ書式で1行に表示する
+    /// @param out 書き込み先のバッファ
+    /// @param var 表示する構造体
+    /// @param layout 最上位の構造体のレイアウト
+    /// @param index 次に使う固定文字列の番号
+    /// @param limits コンテナ型メンバーの表示の上限
+    template <typename Layout, typename U>
+    void AppendStructValues(std::string& out, const U& var, const Layout& layout, std::size_t& index, const PrintLimits& limits)
+    {
+        boost::pfr::for_each_field(var, [&]<typename Field>(const Field & field)
+        {
+            if constexpr (is_reflectable<Field>::value)
+            {
+                AppendStructValues(out, field, layout, index, limits);
             }
             else
             {
-                out << indentStr
-                    << variableString() << pairSeparatorString() << memberName << "  "
-                    << valueString() << pairSeparatorString() << field << "\n";
-                PrintMessage(out.str(), color);
+                out += layout.Fragment(index++);
+                AppendFormatted(out, field, 0, limits);
             }
         });
     }
 
+    /// @brief 構造体のメンバーを再帰的に文字列バッファへ書き込むヘルパー。
+    /// 型ごとのレイアウトを使い、インデントレベルに応じて階層構造を表現する
+    /// @param out 書き込み先のバッファ
+    /// @param var 表示する構造体
+    /// @param indent 先頭のインデントレベル
+    template <typename T>
+    void AppendStructMembers(std::string& out, const T& var, int indent)
+    {
+        const StructLayout<T>& layout = StructLayout<T>::Get(indent);
+        std::size_t index = 0;
+        AppendStructValues(out, var, layout, index, GetPrintLimits());
+        out += layout.Fragment(index);
+    }
+
     /// @brief 構造体名とメンバーをコンソールに表示する。
     /// Boost.PFR を使ってメンバーを自動取得し、ネストした集成体は再帰的に表示する。
+    /// 構造体全体をスレッドごとの再利用バッファに組み立ててから1回で出力するため、
+    /// 複数スレッドから呼び出しても行が混ざらない。
     /// PRINT_STRUCT マクロから呼び出される
     /// @param name 構造体変数名の文字列
     /// @param var 表示する構造体
@@ -86,12 +167,174 @@ namespace DebugPrint
         static_assert(is_reflectable<T>::value,
             "PRINT_STRUCT は集成体(継承なし・仮想関数なし・ユーザー定義コンストラクタなし)のみ対応しています");
 
-        std::ostringstream out;
-        out << separatorString()
-            << variableString() << pairSeparatorString() << name << "\n";
-        PrintMessage(out.str(), color);
-        PrintStructMembers(var, color, indent);
-        PrintMessage(separatorString(), color);
+        // 記録モードでは書式化せず、バイト列をそのまま記録する
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (DebugPrintConfig::GetInstance().IsStructCaptureEnabled())
+            {
+                StructCapture::GetInstance().Capture(name, var);
+                return;
+            }
+        }
+
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        out += separatorString();
+        out += variableString();
+        out += pairSeparatorString();
+        out += name;
+        out += '\n';
+        AppendStructMembers(out, var, indent);
+        out += separatorString();
+        PrintMessage(out, color);
+    }
+
+    /// @brief PRINT_STRUCT_DIFF の呼び出し箇所ごとに前回表示した値を保持するスナップショット
+    template <typename T>
+    struct StructSnapshot
+    {
+        std::mutex       mutex;  // last の排他制御用
+        std::optional<T> last;   // 前回表示した値(未表示の場合は空)
+    };
+
+    /// @brief 構造体のメンバーの値が等しいかどうかを判定する。
+    /// 浮動小数点数は表示が変わる 0.0 と -0.0 を区別し、NaN どうしは等しいとみなす。
+    /// == 演算子がない型は書式化した文字列で比較する
+    template <typename Field>
+    [[nodiscard]] bool FieldEquals(const Field& before, const Field& after, const PrintLimits& limits)
+    {
+        if constexpr (std::is_floating_point_v<Field>)
+        {
+            if (std::isnan(before) || std::isnan(after))
+            {
+                return std::isnan(before) && std::isnan(after);
+            }
+            return before == after && std::signbit(before) == std::signbit(after);
+        }
+        else if constexpr (std::equality_comparable<Field>)
+        {
+            return before == after;
+        }
+        else
+        {
+            std::string beforeText;
+            std::string afterText;
+            AppendFormatted(beforeText, before, 0, limits);
+            AppendFormatted(afterText, after, 0, limits);
+            return beforeText == afterText;
+        }
+    }
+
+    // 前方宣言
+    template <typename U>
+    void AppendStructDiff(std::string& out, const U& before, const U& after, std::string& path, const PrintLimits& limits);
+
+    /// @brief 構造体の1つのメンバーを比較し、変化していれば "メンバー名  値: 前 -> 後" の1行を追加する。
+    /// メンバーの経路("transform.position.x" など)は変化した場合のみ組み立てる
+    /// @param out 追加先のバッファ
+    /// @param before 前回の値
+    /// @param after 今回の値
+    /// @param memberName メンバー名
+    /// @param path 親の構造体までの経路
+    /// @param limits コンテナ型メンバーの表示の上限
+    template <typename Field>
+    void AppendFieldDiff(
+        std::string& out,
+        const Field& before,
+        const Field& after,
+        std::string_view memberName,
+        std::string& path,
+        const PrintLimits& limits)
+    {
+        const std::size_t parentLength = path.size();
+        if constexpr (is_reflectable<Field>::value)
+        {
+            if (parentLength > 0) path += '.';
+            path += memberName;
+            AppendStructDiff(out, before, after, path, limits);
+            path.resize(parentLength);
+        }
+        else
+        {
+            if (FieldEquals(before, after, limits)) return;
+
+            out += variableString();
+            out += pairSeparatorString();
+            out += path;
+            if (parentLength > 0) out += '.';
+            out += memberName;
+            out += "  ";
+            out += valueString();
+            out += pairSeparatorString();
+            AppendFormatted(out, before, 0, limits);
+            out += " -> ";
+            AppendFormatted(out, after, 0, limits);
+            out += '\n';
+        }
+    }
+
+    /// @brief 構造体の全メンバーを Boost.PFR で比較し、変化したメンバーの行を追加する。
+    /// ネストした集成体は再帰的に比較する
+    /// @param out 追加先のバッファ
+    /// @param before 前回の値
+    /// @param after 今回の値
+    /// @param path 親の構造体までの経路
+    /// @param limits コンテナ型メンバーの表示の上限
+    template <typename U>
+    void AppendStructDiff(std::string& out, const U& before, const U& after, std::string& path, const PrintLimits& limits)
+    {
+        constexpr auto memberNames = boost::pfr::names_as_array<U>();
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (AppendFieldDiff(out, boost::pfr::get<I>(before), boost::pfr::get<I>(after), memberNames[I], path, limits), ...);
+        }(std::make_index_sequence<boost::pfr::tuple_size_v<U>>{});
+    }
+
+    /// @brief 構造体を前回表示した値と比較し、変化したメンバーのみを前後の値とともに表示する。
+    /// 初回は PRINT_STRUCT と同じく全メンバーを表示し、変化がない場合は何も表示しない。
+    /// トリビアルにコピー可能な型は、まずメモリ全体を memcmp で比較して変化がなければすぐに戻る。
+    /// PRINT_STRUCT_DIFF マクロから呼び出される
+    /// @param name 構造体変数名の文字列
+    /// @param var 表示する構造体
+    /// @param snapshot 呼び出し箇所ごとのスナップショット
+    /// @param color 表示色
+    template <typename T>
+    void PrintStructDiff(const char* name, const T& var, StructSnapshot<T>& snapshot, Color color = PRINT_COLOR::DEFAULT)
+    {
+        static_assert(is_reflectable<T>::value,
+            "PRINT_STRUCT_DIFF は集成体(継承なし・仮想関数なし・ユーザー定義コンストラクタなし)のみ対応しています");
+
+        std::lock_guard<std::mutex> lock(snapshot.mutex);
+        if (!snapshot.last)
+        {
+            snapshot.last.emplace(var);
+            PrintStruct(name, var, color);
+            return;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (std::memcmp(&*snapshot.last, &var, sizeof(T)) == 0) return;
+        }
+
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        out += separatorString();
+        out += variableString();
+        out += pairSeparatorString();
+        out += name;
+        out += '\n';
+        const std::size_t headerLength = out.size();
+
+        std::string path;
+        AppendStructDiff(out, *snapshot.last, var, path, GetPrintLimits());
+        *snapshot.last = var;
+
+        // パディングのみが異なる場合など、変化したメンバーがなければ何も表示しない
+        if (out.size() == headerLength) return;
+
+        out += separatorString();
+        PrintMessage(out, color);
     }
 
 } // namespace DebugPrint
\ No newline at end of file
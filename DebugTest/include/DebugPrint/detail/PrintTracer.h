@@ -3,12 +3,23 @@
 #include "PrintFunction.h"
 #include "TemplateStrings.h"
 #include "TimeUtility.h"
+#include "ClassTraceStats.h"
+#include "AllocationCounter.h"
+#include "ScopeProfiler.h"
+#include "PerfCounters.h"
+#include "FlameGraph.h"
 
 namespace DebugPrint
 {
     /// @brief PRINT_TRACE_FUNCTION マクロから使用される、関数の開始・終了と経過時間を出力するクラス。
     /// コンストラクタで関数の開始情報を出力し、デストラクタで終了情報と経過時間を出力する。
-    /// スコープを抜けると自動的にデストラクタが呼ばれるため、関数の先頭に置くだけで使用できる
+    /// スコープを抜けると自動的にデストラクタが呼ばれるため、関数の先頭に置くだけで使用できる。
+    /// ヒープ確保の追跡が有効な場合はスコープ内の確保回数・バイト数も出力する。
+    /// パフォーマンスカウンタが有効な場合は perf_event_open で計測したサイクル数・IPC・
+    /// キャッシュミスなども出力する(Linux のみ)。
+    /// 計測結果は ScopeProfiler に呼び出し箇所ごとに集計される。
+    /// フレームグラフ出力が有効な場合はスコープの入れ子を FlameGraphCollector に積む。
+    /// Emscripten で User Timing が有効な場合はテキストを出力せず、スコープを performance.measure で記録する
     class FunctionTracer
     {
     public:
@@ -25,62 +36,179 @@ namespace DebugPrint
         /// @param line_number 呼び出し元の行番号
         /// @param color 表示色
         FunctionTracer(const char func_name[], const char file_name[], int line_number, Color color = PRINT_COLOR::DEFAULT) noexcept
+            : m_FuncName(func_name), m_FileName(file_name), m_LineNumber(line_number)
         {
             m_Timer.Start();
             m_Color = color;
-            std::string functionName = func_name;
-            std::string fileName = file_name;
-
-            PrintMessage(separatorString(), m_Color);
-            PrintMessage(GetDateTimeString() + "\n", m_Color);
-            PrintMessage(fileString() + pairSeparatorString() + fileName + "\n" +
-                LineNumberString() + pairSeparatorString() +
-                std::to_string(line_number) + "\n", m_Color);
-            PrintMessage(functionName, m_Color);
-            PrintMessage(startFunctionString(), m_Color);
+
+            // User Timing で記録する場合は、日時の取得を含めてテキストの出力を行わない
+            m_UserTiming = DebugPrintConfig::GetInstance().IsUserTimingEnabled();
+            if (!m_UserTiming)
+            {
+                PrintMessage(separatorString(), m_Color);
+                PrintMessage(GetDateTimeString() + "\n", m_Color);
+                PrintMessage(fileString() + pairSeparatorString() + file_name + "\n" +
+                    LineNumberString() + pairSeparatorString() +
+                    std::to_string(line_number) + "\n", m_Color);
+                PrintMessage(func_name, m_Color);
+                PrintMessage(startFunctionString(), m_Color);
+            }
+
+            if (DebugPrintConfig::GetInstance().IsFlameGraphEnabled())
+            {
+                m_InFlameGraph = true;
+                FlameGraphCollector::GetInstance().PushScope(func_name);
+            }
+
+            // 開始情報の出力による確保を含めないよう、出力後にスナップショットを取る
+            m_StartAllocations = GetThreadAllocationCounters();
+            if (DebugPrintConfig::GetInstance().IsPerfCountersEnabled())
+            {
+                m_StartPerf = ReadThreadPerfCounters();
+            }
         }
 
         /// @brief 関数の終了情報と経過時間を出力するデストラクタ
         ~FunctionTracer() noexcept
         {
-            PrintMessage(endFunctionString(), m_Color);
-            PrintMessage(endTimerString(), m_Color);
-            PrintMessage(m_Timer.GetElapsedSecTime(), m_Color);
-            PrintMessage(secondsString() + "\n", m_Color);
-            PrintMessage(separatorString(), m_Color);
+            const uint64_t elapsed = m_Timer.GetElapsedNanoseconds();
+            const AllocationCounters allocations = GetThreadAllocationCounters() - m_StartAllocations;
+            const bool perfEnabled = DebugPrintConfig::GetInstance().IsPerfCountersEnabled() && m_StartPerf.HasAny();
+            const PerfCounterValues perf = perfEnabled ? ReadThreadPerfCounters() - m_StartPerf : PerfCounterValues{};
+
+            if (m_UserTiming)
+            {
+#if defined(__EMSCRIPTEN__)
+                js_performance_measure(m_FuncName, m_FileName, m_LineNumber,
+                    static_cast<double>(m_Timer.GetStartNanoseconds()) / 1000000.0,
+                    static_cast<double>(elapsed) / 1000000.0);
+#endif
+            }
+            else
+            {
+                PrintMessage(endFunctionString(), m_Color);
+                PrintMessage(endTimerString(), m_Color);
+                PrintMessage(m_Timer.GetElapsedSecTime(), m_Color);
+                PrintMessage(secondsString() + "\n", m_Color);
+                if (IsAllocationTrackingEnabled())
+                {
+                    PrintMessage(allocCountString() + pairSeparatorString() + std::to_string(allocations.allocCount) + "\n" +
+                        allocBytesString() + pairSeparatorString() + std::to_string(allocations.allocBytes) + "\n" +
+                        freeCountString() + pairSeparatorString() + std::to_string(allocations.freeCount) + "\n", m_Color);
+                }
+                if (perfEnabled)
+                {
+                    PrintMessage(FormatPerfCounters(perf), m_Color);
+                }
+                PrintMessage(separatorString(), m_Color);
+            }
+
+            ScopeProfiler::GetInstance().Record(m_FuncName, m_FileName, m_LineNumber, elapsed, allocations);
+            if (m_InFlameGraph)
+            {
+                FlameGraphCollector::GetInstance().PopScope(elapsed);
+            }
         }
 
     private:
-        Color m_Color;  // 表示色
-        Timer m_Timer;  // 経過時間計測用タイマー
+
+        /// @brief パフォーマンスカウンタの差分を表示用の文字列にする。
+        /// 使用できなかったカウンタは表示しない
+        /// @param perf スコープ内のカウンタの差分
+        static std::string FormatPerfCounters(const PerfCounterValues& perf)
+        {
+            std::ostringstream out;
+            auto line = [&](PerfCounter counter, const std::string& label)
+            {
+                if (perf.Has(counter))
+                {
+                    out << label << pairSeparatorString() << perf.Get(counter) << "\n";
+                }
+            };
+
+            line(PerfCounter::Cycles, perfCyclesString());
+            line(PerfCounter::Instructions, perfInstructionsString());
+            if (perf.Has(PerfCounter::Cycles) && perf.Has(PerfCounter::Instructions) && perf.Get(PerfCounter::Cycles) > 0)
+            {
+                out << perfIpcString() << pairSeparatorString()
+                    << std::fixed << std::setprecision(2)
+                    << static_cast<double>(perf.Get(PerfCounter::Instructions)) / static_cast<double>(perf.Get(PerfCounter::Cycles))
+                    << std::defaultfloat << "\n";
+            }
+            line(PerfCounter::CacheMisses, perfCacheMissesString());
+            line(PerfCounter::BranchMisses, perfBranchMissesString());
+            line(PerfCounter::ContextSwitches, perfContextSwitchesString());
+            if (perf.Has(PerfCounter::TaskClock))
+            {
+                out << perfTaskClockString() << pairSeparatorString()
+                    << static_cast<double>(perf.Get(PerfCounter::TaskClock)) / 1e9 << secondsString() << "\n";
+            }
+            line(PerfCounter::PageFaults, perfPageFaultsString());
+            return out.str();
+        }
+
+        const char*        m_FuncName;          // 呼び出し元の関数名
+        const char*        m_FileName;          // 呼び出し元のファイル名
+        int                m_LineNumber;        // 呼び出し元の行番号
+        Color              m_Color;             // 表示色
+        Timer              m_Timer;             // 経過時間計測用タイマー
+        AllocationCounters m_StartAllocations;  // 開始時のヒープ確保カウンタ
+        PerfCounterValues  m_StartPerf;         // 開始時のパフォーマンスカウンタ
+        bool               m_InFlameGraph = false;  // FlameGraphCollector にスコープを積んだかどうか
+        bool               m_UserTiming   = false;  // テキストの代わりに User Timing で記録するかどうか
     };
 
 
-    /// @brief PRINT_TRACE_CLASS マクロから使用される、クラスのコンストラクタ・デストラクタの呼び出しを出力するクラス。
-    /// コンストラクタ呼び出し時に開始メッセージを、デストラクタ呼び出し時に終了メッセージを出力する。
-    /// メンバ変数として宣言することでクラスのライフサイクルを追跡できる
+    /// @brief PRINT_TRACE_CLASS マクロから使用される、クラスの生成・破棄を追跡するクラス。
+    /// メンバ変数として宣言することでクラスのライフサイクルを追跡できる。
+    /// クラス名と表示色はタグ型から取得し、統計は ClassTraceRegistry に型ごとに1つだけ保持する。
+    /// このクラス自体はデータを持たないため、[[no_unique_address]] と併用すれば
+    /// 追跡対象クラスのサイズは増えない
+    /// @tparam Tag クラス名(ClassName)と表示色(TraceColor)を返す静的メンバ関数を持つタグ型
+    template <typename Tag>
     class ClassTracer
     {
     public:
-        /// @brief クラスの開始メッセージを出力するコンストラクタ
-        /// @param class_name 追跡するクラス名
-        /// @param color 表示色
-        ClassTracer(const char class_name[], Color color = PRINT_COLOR::GREEN)
-        {
-            m_ClassName = class_name;
-            m_Color = color;
-            PrintMessage(m_ClassName + startClassString(), m_Color);
-        }
+        /// @brief インスタンスの生成を記録するコンストラクタ
+        ClassTracer() { OnConstruct(); }
+        /// @brief コピー生成もインスタンスの生成として記録する
+        ClassTracer(const ClassTracer&) { OnConstruct(); }
+        /// @brief ムーブ生成もインスタンスの生成として記録する
+        ClassTracer(ClassTracer&&) noexcept { OnConstruct(); }
+        /// @brief 代入はインスタンス数が変わらないため何もしない
+        ClassTracer& operator=(const ClassTracer&) { return *this; }
+        /// @brief 代入はインスタンス数が変わらないため何もしない
+        ClassTracer& operator=(ClassTracer&&) noexcept { return *this; }
 
-        /// @brief クラスの終了メッセージを出力するデストラクタ
+        /// @brief インスタンスの破棄を記録するデストラクタ
         ~ClassTracer()
         {
-            PrintMessage(m_ClassName + endClassString(), m_Color);
+            GetStats().OnDestruct(this);
+            if (DebugPrintConfig::GetInstance().IsTraceClassEventsEnabled())
+            {
+                PrintMessage(std::string(Tag::ClassName()) + endClassString(), Tag::TraceColor());
+            }
         }
 
     private:
-        std::string m_ClassName;  // 追跡するクラス名
-        Color       m_Color;      // 表示色
+
+        /// @brief このクラス用の統計情報を取得する。初回呼び出し時にレジストリへ登録する
+        static ClassTraceStats& GetStats()
+        {
+            static ClassTraceStats& stats =
+                ClassTraceRegistry::GetInstance().Register(Tag::ClassName(), Tag::TraceColor());
+            return stats;
+        }
+
+        /// @brief 生成を記録し、設定が有効な場合は開始メッセージを出力する
+        void OnConstruct()
+        {
+            GetStats().OnConstruct(this);
+            if (DebugPrintConfig::GetInstance().IsTraceClassEventsEnabled())
+            {
+                PrintMessage(std::string(Tag::ClassName()) + startClassString(), Tag::TraceColor());
+            }
+        }
     };
 
 } // namespace DebugPrint
\ No newline at end of file
@@ -1,117 +1,467 @@
 #pragma once
-#include <sstream>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <ranges>
 #include <string>
-#include <vector>
-#include <array>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <boost/pfr.hpp>
 #include "PrintFunction.h"
 #include "TemplateStrings.h"
+#include "DebugPrintConfig.h"
+#include "FormatBuffer.h"
+#include "NumericFormat.h"
 #include "../third_party/magic_enum/magic_enum.hpp"
 
 namespace DebugPrint
 {
     // ===== 型判定ヘルパー =====
 
-    /// @brief C配列かどうかを判定する
+    /// @brief 文字列として表示する型かどうかを判定する
     template <typename T>
-    constexpr bool is_c_array = std::is_array<T>::value;
+    concept StringLike = std::is_convertible_v<const T&, std::string_view>;
 
-    /// @brief std::vector かどうかを判定する
+    /// @brief 文字列として表示する値を std::string_view にする。
+    /// char 配列は終端の '\0' を含むとは限らないため、配列の長さを超えて読まないようにする
+    template <StringLike T>
+    [[nodiscard]] std::string_view ToStringView(const T& value)
+    {
+        if constexpr (std::is_array_v<T>)
+        {
+            const auto end = std::find(std::begin(value), std::end(value), '\0');
+            return std::string_view(value, static_cast<std::size_t>(end - std::begin(value)));
+        }
+        else
+        {
+            return std::string_view(value);
+        }
+    }
+
+    /// @brief 要素を順に表示する範囲(C配列・STLコンテナ・std::span など)かどうかを判定する。
+    /// 文字列は範囲でもあるが文字列として表示するため除外する
+    template <typename T>
+    concept PrintableRange = std::ranges::input_range<const T> && !StringLike<T>;
+
+    /// @brief キーと値の組を要素に持つ連想コンテナ(std::map・std::unordered_map など)かどうかを判定する
+    template <typename T>
+    concept MapLikeRange = PrintableRange<T> && requires
+    {
+        typename T::key_type;
+        typename T::mapped_type;
+    };
+
+    /// @brief std::tuple・std::pair のようにタプルとして扱える型かどうかを判定する
+    template <typename T>
+    concept TupleLike = !PrintableRange<T> && requires
+    {
+        std::tuple_size<T>::value;
+    };
+
+    /// @brief << 演算子で出力できる型かどうかを判定する
+    template <typename T>
+    concept StreamInsertable = requires(std::ostream & os, const T & v) { os << v; };
+
+    /// @brief std::optional かどうかを判定する
     template <typename T>
-    struct is_vector : std::false_type {};
+    struct is_optional : std::false_type {};
 
-    template <typename T, typename A>
-    struct is_vector<std::vector<T, A>> : std::true_type {};
+    template <typename T>
+    struct is_optional<std::optional<T>> : std::true_type {};
 
-    /// @brief std::array かどうかを判定する
+    /// @brief std::variant かどうかを判定する
     template <typename T>
-    struct is_std_array : std::false_type {};
+    struct is_variant : std::false_type {};
+
+    template <typename... Ts>
+    struct is_variant<std::variant<Ts...>> : std::true_type {};
 
-    template <typename T, std::size_t N>
-    struct is_std_array<std::array<T, N>> : std::true_type {};
+    /// @brief 要素を順に表示する範囲かどうかを判定する
+    template <typename T>
+    struct is_array_like : std::bool_constant<PrintableRange<T>> {};
 
-    /// @brief C配列・std::vector・std::array のいずれかかどうかを判定する
+    /// @brief Boost.PFR で扱える集成体かどうかを判定するヘルパー。
+    /// 集成体の条件: 継承なし・仮想関数なし・ユーザー定義コンストラクタなし
     template <typename T>
-    struct is_array_like : std::disjunction<
-        std::is_array<T>,
-        is_vector<T>,
-        is_std_array<T>
-    > {
+    struct is_reflectable
+    {
+        static constexpr bool value =
+            std::is_aggregate<T>::value &&
+            !is_array_like<T>::value &&
+            !std::is_array<T>::value;
     };
 
-    /// @brief 列挙型変数の名前と値をコンソールに表示する。
-    /// magic_enum を使って列挙値を文字列に変換して表示する。
-    /// PRINT_VARIABLE マクロから呼び出される
-    /// @param name 変数名の文字列
-    /// @param var 表示する列挙型変数
-    /// @param color 表示色
+
+    // ===== 表示の上限 =====
+
+    // 要素数が不明な範囲で省略数を表す値
+    inline constexpr std::size_t UNKNOWN_ELEMENT_COUNT = (std::numeric_limits<std::size_t>::max)();
+
+    /// @brief コンテナ表示時の上限設定
+    struct PrintLimits
+    {
+        std::size_t maxElements;  // 1つの範囲で表示する最大要素数(超えた分は先頭と末尾を残して省略する)
+        std::size_t maxDepth;     // 入れ子のコンテナを展開する最大の深さ
+    };
+
+    /// @brief 現在の設定からコンテナ表示時の上限を取得する
+    [[nodiscard]] inline PrintLimits GetPrintLimits()
+    {
+        const DebugPrintConfig& config = DebugPrintConfig::GetInstance();
+        return { config.GetPrintMaxElements(), config.GetPrintMaxDepth() };
+    }
+
+    /// @brief 範囲の要素を上限付きで走査する。
+    /// 要素数が上限を超える場合、双方向に走査できる範囲は先頭と末尾を、
+    /// それ以外は先頭のみを走査し、間の省略数を onOmitted に渡す。
+    /// 省略された要素には触れないため、処理量は要素数ではなく上限に比例する
+    /// @param range 走査する範囲
+    /// @param maxElements 走査する最大要素数
+    /// @param onElement 要素ごとに (番号, 要素) で呼ばれる関数
+    /// @param onOmitted 省略があった場合に省略数で呼ばれる関数。数が不明な場合は UNKNOWN_ELEMENT_COUNT
+    template <typename R, typename ElementFunc, typename OmittedFunc>
+    void ForEachLimited(const R& range, std::size_t maxElements, ElementFunc&& onElement, OmittedFunc&& onOmitted)
+    {
+        if constexpr (std::ranges::sized_range<const R> &&
+                      std::ranges::bidirectional_range<const R> &&
+                      std::ranges::common_range<const R>)
+        {
+            const std::size_t size = static_cast<std::size_t>(std::ranges::size(range));
+            auto it = std::ranges::begin(range);
+            if (size <= maxElements)
+            {
+                for (std::size_t i = 0; i < size; ++i, ++it)
+                {
+                    onElement(i, *it);
+                }
+                return;
+            }
+
+            const std::size_t tail = maxElements / 2;
+            const std::size_t head = maxElements - tail;
+            for (std::size_t i = 0; i < head; ++i, ++it)
+            {
+                onElement(i, *it);
+            }
+            onOmitted(size - head - tail);
+
+            auto tailIt = std::ranges::prev(std::ranges::end(range), static_cast<std::ptrdiff_t>(tail));
+            for (std::size_t i = size - tail; i < size; ++i, ++tailIt)
+            {
+                onElement(i, *tailIt);
+            }
+        }
+        else
+        {
+            auto it = std::ranges::begin(range);
+            const auto last = std::ranges::end(range);
+            std::size_t i = 0;
+            for (; it != last && i < maxElements; ++it, ++i)
+            {
+                onElement(i, *it);
+            }
+            if (it != last)
+            {
+                if constexpr (std::ranges::sized_range<const R>)
+                {
+                    onOmitted(static_cast<std::size_t>(std::ranges::size(range)) - i);
+                }
+                else
+                {
+                    onOmitted(UNKNOWN_ELEMENT_COUNT);
+                }
+            }
+        }
+    }
+
+
+    // ===== 値の書式化 =====
+
+    /// @brief 値を1行に収まる形式でバッファに追加する。
+    /// 範囲は {a, b, c}、連想コンテナは {key: value}、タプルは (a, b)、
+    /// 集成体は {member: value} の形式で表示し、入れ子は上限の深さまで展開する
+    /// @param out 追加先のバッファ
+    /// @param value 追加する値
+    /// @param depth 現在の入れ子の深さ
+    /// @param limits 表示の上限
     template <typename T>
-    std::enable_if_t<std::is_enum<T>::value>
-        PrintVariable(const char* name, const T& var, Color color = PRINT_COLOR::DEFAULT)
+    void AppendFormatted(std::string& out, const T& value, std::size_t depth, const PrintLimits& limits);
+
+    /// @brief 範囲の要素を {a, b, c} の形式でバッファに追加する
+    template <typename R>
+    void AppendRangeInline(std::string& out, const R& range, std::size_t depth, const PrintLimits& limits)
     {
-        std::ostringstream outputString;
-        outputString << variableString() << pairSeparatorString() << name << "  ";
-        outputString << valueString() << pairSeparatorString() << magic_enum::enum_name(var) << "\n";
-        PrintMessage(outputString.str(), color);
+        if (depth >= limits.maxDepth)
+        {
+            out += "{...}";
+            return;
+        }
+
+        out += '{';
+        bool first = true;
+        auto separator = [&]
+        {
+            if (!first) out += ", ";
+            first = false;
+        };
+        ForEachLimited(range, limits.maxElements,
+            [&](std::size_t, const auto& element)
+            {
+                separator();
+                if constexpr (MapLikeRange<R>)
+                {
+                    AppendFormatted(out, element.first, depth + 1, limits);
+                    out += ": ";
+                    AppendFormatted(out, element.second, depth + 1, limits);
+                }
+                else
+                {
+                    AppendFormatted(out, element, depth + 1, limits);
+                }
+            },
+            [&](std::size_t)
+            {
+                separator();
+                out += "...";
+            });
+        out += '}';
     }
 
-    /// @brief 通常型変数の名前と値をコンソールに表示する。
-    /// 配列型・列挙型以外の << 演算子が定義された型に対応する。
-    /// PRINT_VARIABLE マクロから呼び出される
-    /// @param name 変数名の文字列
-    /// @param var 表示する変数
-    /// @param color 表示色
     template <typename T>
-    std::enable_if_t<!is_array_like<T>::value && !std::is_enum<T>::value>
-        PrintVariable(const char* name, const T& var, Color color = PRINT_COLOR::DEFAULT)
+    void AppendFormatted(std::string& out, const T& value, std::size_t depth, const PrintLimits& limits)
     {
-        static_assert(requires(std::ostream & os, const T & v) { os << v; },
-            "PRINT_VARIABLE は << 演算子が定義されていない型には使用できません。"
-            "構造体の場合は PRINT_STRUCT を使用してください");
-
-        std::ostringstream outputString;
-        outputString << variableString() << pairSeparatorString() << name << "  ";
-        outputString << valueString() << pairSeparatorString() << var << "\n";
-        PrintMessage(outputString.str(), color);
+        if constexpr (std::is_enum_v<T>)
+        {
+            const auto name = magic_enum::enum_name(value);
+            if (name.empty())
+            {
+                // magic_enum の範囲外の値は数値で表示する
+                AppendValue(out, static_cast<std::underlying_type_t<T>>(value));
+            }
+            else
+            {
+                out += name;
+            }
+        }
+        else if constexpr (StringLike<T>)
+        {
+            out += ToStringView(value);
+        }
+        else if constexpr (PrintableRange<T>)
+        {
+            AppendRangeInline(out, value, depth, limits);
+        }
+        else if constexpr (is_optional<T>::value)
+        {
+            if (value.has_value())
+            {
+                AppendFormatted(out, *value, depth, limits);
+            }
+            else
+            {
+                out += "nullopt";
+            }
+        }
+        else if constexpr (is_variant<T>::value)
+        {
+            if (value.valueless_by_exception())
+            {
+                out += "valueless";
+            }
+            else
+            {
+                std::visit([&](const auto& alternative) { AppendFormatted(out, alternative, depth, limits); }, value);
+            }
+        }
+        else if constexpr (TupleLike<T>)
+        {
+            if (depth >= limits.maxDepth)
+            {
+                out += "(...)";
+                return;
+            }
+            out += '(';
+            std::apply([&](const auto&... elements)
+            {
+                std::size_t index = 0;
+                ((out += (index++ == 0 ? "" : ", "), AppendFormatted(out, elements, depth + 1, limits)), ...);
+            }, value);
+            out += ')';
+        }
+        else if constexpr (StreamInsertable<T>)
+        {
+            AppendValue(out, value);
+        }
+        else if constexpr (is_reflectable<T>::value)
+        {
+            if (depth >= limits.maxDepth)
+            {
+                out += "{...}";
+                return;
+            }
+            constexpr auto memberNames = boost::pfr::names_as_array<T>();
+            out += '{';
+            boost::pfr::for_each_field(value, [&](const auto& field, std::size_t idx)
+            {
+                if (idx != 0) out += ", ";
+                out += memberNames[idx];
+                out += ": ";
+                AppendFormatted(out, field, depth + 1, limits);
+            });
+            out += '}';
+        }
+        else
+        {
+            static_assert(StreamInsertable<T>,
+                "PRINT_VARIABLE は << 演算子が定義されていない型には使用できません。"
+                "構造体の場合は PRINT_STRUCT を使用してください");
+        }
     }
 
-    /// @brief C配列の変数名・要素数・各要素の値をコンソールに表示する。
-    /// PRINT_VARIABLE マクロから呼び出される
-    /// @param varName 変数名の文字列
-    /// @param arr 表示するC配列
-    /// @param color 表示色
-    template <typename T, std::size_t N>
-    void PrintVariable(const std::string& varName, const T(&arr)[N], Color color = PRINT_COLOR::DEFAULT)
+
+    // ===== 変数の表示 =====
+
+    /// @brief 省略された要素数を表す行をバッファに追加する
+    /// @param out 追加先のバッファ
+    /// @param omitted 省略された要素数。不明な場合は UNKNOWN_ELEMENT_COUNT
+    inline void AppendOmittedLine(std::string& out, std::size_t omitted)
     {
-        std::ostringstream outputString;
-        outputString << variableString() << varName
-            << openString() << N << closeString() << pairSeparatorString() << "\n";
-        for (size_t i = 0; i < N; ++i)
+        out += "...  ";
+        out += omittedElementsString();
+        out += pairSeparatorString();
+        if (omitted == UNKNOWN_ELEMENT_COUNT)
+        {
+            out += '?';
+        }
+        else
         {
-            outputString << openString() << i << closeString() << pairSeparatorString() << arr[i] << "\n";
+            AppendValue(out, omitted);
         }
-        PrintMessage(outputString.str(), color);
+        out += '\n';
     }
 
-    /// @brief std::vector または std::array の変数名・要素数・各要素の値をコンソールに表示する。
+    /// @brief 連続した数値の並びの各要素をバッファに追加する。
+    /// 要素ごとの書式化を介さず一括で書き出す高速版で、
+    /// 列数の設定が2以上の場合は複数列にまとめて表示する
+    /// @param out 追加先のバッファ
+    /// @param range 表示する範囲
+    /// @param limits 表示の上限
+    template <NumericContiguousRange R>
+    void AppendNumericRange(std::string& out, const R& range, const PrintLimits& limits)
+    {
+        const auto* data = std::ranges::data(range);
+        const std::size_t size = static_cast<std::size_t>(std::ranges::size(range));
+        const std::size_t columns = DebugPrintConfig::GetInstance().GetPrintColumns();
+        const std::string& open = openString();
+        const std::string closeSeparator = closeString() + pairSeparatorString();
+
+        auto append = [&](std::size_t first, std::size_t count)
+        {
+            if (columns > 1)
+            {
+                AppendNumericColumns(out, data + first, first, count, columns, open, closeSeparator);
+            }
+            else
+            {
+                AppendNumericLines(out, data + first, first, count, open, closeSeparator);
+            }
+        };
+
+        if (size <= limits.maxElements)
+        {
+            append(0, size);
+            return;
+        }
+
+        const std::size_t tail = limits.maxElements / 2;
+        const std::size_t head = limits.maxElements - tail;
+        append(0, head);
+        AppendOmittedLine(out, size - head - tail);
+        append(size - tail, tail);
+    }
+
+    /// @brief 変数の名前と値をコンソールに表示する。
+    /// C配列・STLコンテナ・std::span などの範囲は要素数と各要素を1行ずつ表示し、
+    /// 連想コンテナはキーを添字の代わりに表示する。
+    /// 要素数が上限を超える場合は先頭と末尾のみを表示し、間を省略する。
+    /// それ以外の型(列挙型・std::optional・std::variant・std::tuple・std::pair・
+    /// << 演算子が定義された型)は1行で表示する。
     /// PRINT_VARIABLE マクロから呼び出される
-    /// @param varName 変数名の文字列
-    /// @param container 表示するコンテナ
+    /// @param name 変数名の文字列
+    /// @param var 表示する変数
     /// @param color 表示色
-    template <typename Container>
-    std::enable_if_t<is_array_like<Container>::value && !std::is_array<Container>::value>
-        PrintVariable(const std::string& varName, const Container& container, Color color = PRINT_COLOR::DEFAULT)
+    template <typename T>
+    void PrintVariable(const char* name, const T& var, Color color = PRINT_COLOR::DEFAULT)
     {
-        std::ostringstream outputString;
-        outputString << variableString() << varName
-            << openString() << container.size() << closeString() << pairSeparatorString() << "\n";
+        const PrintLimits limits = GetPrintLimits();
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
 
-        size_t index = 0;
-        for (const auto& value : container)
+        if constexpr (PrintableRange<T>)
         {
-            outputString << openString() << index++ << closeString() << pairSeparatorString() << value << "\n";
+            out += variableString();
+            out += name;
+            out += openString();
+            if constexpr (std::ranges::sized_range<const T>)
+            {
+                AppendValue(out, static_cast<std::size_t>(std::ranges::size(var)));
+            }
+            else
+            {
+                out += '?';
+            }
+            out += closeString();
+            out += pairSeparatorString();
+            out += '\n';
+
+            if constexpr (NumericContiguousRange<T>)
+            {
+                AppendNumericRange(out, var, limits);
+            }
+            else
+            {
+                ForEachLimited(var, limits.maxElements,
+                    [&](std::size_t index, const auto& element)
+                    {
+                        out += openString();
+                        if constexpr (MapLikeRange<T>)
+                        {
+                            AppendFormatted(out, element.first, 1, limits);
+                            out += closeString();
+                            out += pairSeparatorString();
+                            AppendFormatted(out, element.second, 1, limits);
+                        }
+                        else
+                        {
+                            AppendValue(out, index);
+                            out += closeString();
+                            out += pairSeparatorString();
+                            AppendFormatted(out, element, 1, limits);
+                        }
+                        out += '\n';
+                    },
+                    [&](std::size_t omitted) { AppendOmittedLine(out, omitted); });
+            }
         }
-        PrintMessage(outputString.str(), color);
+        else
+        {
+            out += variableString();
+            out += pairSeparatorString();
+            out += name;
+            out += "  ";
+            out += valueString();
+            out += pairSeparatorString();
+            AppendFormatted(out, var, 0, limits);
+            out += '\n';
+        }
+
+        PrintMessage(out, color);
     }
 
 } // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,467 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DebugPrintConfig.h"
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "FormatBuffer.h"
+#include "TimeUtility.h"
+
+namespace DebugPrint
+{
+    /// @brief 現在時刻を単調増加するナノ秒で取得する。GetMonotonicNanoseconds() に委譲する
+    [[nodiscard]] inline int64_t GetSteadyNanoseconds()
+    {
+        return static_cast<int64_t>(GetMonotonicNanoseconds());
+    }
+
+    // 前方宣言
+    class CallSiteLimiter;
+
+    /// @brief 出力を間引く呼び出し箇所を登録しておき、抑制した回数をまとめて出力するシングルトンクラス。
+    /// Report() は前回の出力以降に抑制した回数がある箇所のみを出力し、プログラム終了時にも呼ばれる
+    class SuppressionRegistry
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static SuppressionRegistry& GetInstance()
+        {
+            static SuppressionRegistry instance;
+            return instance;
+        }
+
+        /// @brief 呼び出し箇所を登録する。CallSiteLimiter のコンストラクタから一度だけ呼ばれる
+        void Add(CallSiteLimiter* limiter)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Limiters.push_back(limiter);
+        }
+
+        /// @brief 前回の出力以降に抑制した回数を呼び出し箇所ごとに出力する
+        inline void Report();
+
+        // コピー・ムーブ禁止
+        SuppressionRegistry(const SuppressionRegistry&) = delete;
+        SuppressionRegistry& operator=(const SuppressionRegistry&) = delete;
+        SuppressionRegistry(SuppressionRegistry&&) = delete;
+        SuppressionRegistry& operator=(SuppressionRegistry&&) = delete;
+
+    private:
+
+        /// @brief コンストラクタ。
+        /// 終了時の出力で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+        SuppressionRegistry()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)GetOutputMutex();
+            (void)DuplicateFilter::GetInstance();
+        }
+
+        /// @brief デストラクタ。出力されないまま抑制された回数が残っていれば出力する
+        ~SuppressionRegistry()
+        {
+            Report();
+        }
+
+        std::mutex m_Mutex;  // m_Limiters の排他制御用
+        std::vector<CallSiteLimiter*> m_Limiters;  // 登録された呼び出し箇所
+    };
+
+    /// @brief PRINT_*_ONCE・PRINT_*_EVERY_N・PRINT_*_EVERY_MS の呼び出し箇所ごとに置かれる間引きの状態。
+    /// 抑制する呼び出しはアトミック変数の加算(EVERY_MS は時刻の取得も)だけで戻り、メッセージの書式化は一切行わない。
+    /// 関数内の static 変数として置かれ、デストラクタを持たないためプログラム終了時の集計からも参照できる
+    class CallSiteLimiter
+    {
+    public:
+
+        /// @param funcName 呼び出し元の関数名
+        /// @param fileName 呼び出し元のファイル名
+        /// @param lineNumber 呼び出し元の行番号
+        CallSiteLimiter(const char* funcName, const char* fileName, int lineNumber)
+            : m_FuncName(funcName), m_FileName(fileName), m_LineNumber(lineNumber)
+        {
+            SuppressionRegistry::GetInstance().Add(this);
+        }
+
+        /// @brief このスレッドで最後に判定を行った呼び出し箇所を取得する。
+        /// 間引きマクロは式として使えるよう状態を名前で参照できないため、出力する回の書式化ではこれを使う。
+        /// 判定の直後(メッセージの式を評価する前)に呼び出すこと
+        [[nodiscard]] static CallSiteLimiter& Current() { return *t_Current; }
+
+        /// @brief 最初の1回だけ出力する
+        /// @return 出力する場合は true
+        [[nodiscard]] bool Once()
+        {
+            t_Current = this;
+            return m_Calls.fetch_add(1, std::memory_order_relaxed) == 0;
+        }
+
+        /// @brief n 回に1回(1回目・n+1回目・…)だけ出力する
+        /// @param n 間隔の回数(0 は 1 とみなす)
+        /// @return 出力する場合は true
+        [[nodiscard]] bool EveryN(uint64_t n)
+        {
+            t_Current = this;
+            const uint64_t index = m_Calls.fetch_add(1, std::memory_order_relaxed);
+            return n <= 1 || index % n == 0;
+        }
+
+        /// @brief 前回の出力から指定時間が経過している場合だけ出力する。
+        /// 同時に複数スレッドから呼ばれても出力するのは1スレッドだけになる
+        /// @param ms 間隔(ミリ秒)
+        /// @return 出力する場合は true
+        [[nodiscard]] bool EveryMs(uint64_t ms)
+        {
+            t_Current = this;
+            m_Calls.fetch_add(1, std::memory_order_relaxed);
+            const int64_t now = GetSteadyNanoseconds();
+            int64_t next = m_NextPrintNs.load(std::memory_order_relaxed);
+            if (now < next) return false;
+            return m_NextPrintNs.compare_exchange_strong(
+                next, now + static_cast<int64_t>(ms) * 1'000'000, std::memory_order_relaxed);
+        }
+
+        /// @brief 前回の出力以降に抑制した回数を取得し、0 に戻す。
+        /// 出力する回の呼び出しは抑制した回数に含めない
+        /// @return 抑制した回数
+        [[nodiscard]] uint64_t TakeSuppressedOnPrint()
+        {
+            const uint64_t calls = m_Calls.load(std::memory_order_relaxed);
+            const uint64_t reported = m_ReportedCalls.exchange(calls, std::memory_order_relaxed);
+            return calls > reported + 1 ? calls - reported - 1 : 0;
+        }
+
+        /// @brief 前回の出力以降に抑制した回数をメッセージに付け加える(出力する回の書式化用)
+        /// @param message メッセージ本文
+        /// @return 付け加えたメッセージ
+        [[nodiscard]] std::string WithSuppressedCount(std::string message);
+
+        /// @brief 前回の出力以降に抑制した回数を取得し、0 に戻す(集計の出力用)
+        /// @return 抑制した回数
+        [[nodiscard]] uint64_t TakeSuppressed()
+        {
+            const uint64_t calls = m_Calls.load(std::memory_order_relaxed);
+            const uint64_t reported = m_ReportedCalls.exchange(calls, std::memory_order_relaxed);
+            return calls > reported ? calls - reported : 0;
+        }
+
+        [[nodiscard]] const char* GetFuncName() const { return m_FuncName; }
+        [[nodiscard]] const char* GetFileName() const { return m_FileName; }
+        [[nodiscard]] int GetLineNumber() const { return m_LineNumber; }
+
+        // コピー・ムーブ禁止
+        CallSiteLimiter(const CallSiteLimiter&) = delete;
+        CallSiteLimiter& operator=(const CallSiteLimiter&) = delete;
+        CallSiteLimiter(CallSiteLimiter&&) = delete;
+        CallSiteLimiter& operator=(CallSiteLimiter&&) = delete;
+
+    private:
+        const char* m_FuncName;    // 呼び出し元の関数名
+        const char* m_FileName;    // 呼び出し元のファイル名
+        int         m_LineNumber;  // 呼び出し元の行番号
+        std::atomic<uint64_t> m_Calls{ 0 };          // 呼び出し回数
+        std::atomic<uint64_t> m_ReportedCalls{ 0 };  // 前回の出力・集計の時点の呼び出し回数
+        std::atomic<int64_t>  m_NextPrintNs{ 0 };    // EVERY_MS で次に出力できる時刻(ナノ秒)
+
+        static inline thread_local CallSiteLimiter* t_Current = nullptr;  // このスレッドで最後に判定を行った呼び出し箇所
+    };
+
+    inline void SuppressionRegistry::Report()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (CallSiteLimiter* limiter : m_Limiters)
+        {
+            const uint64_t suppressed = limiter->TakeSuppressed();
+            if (suppressed == 0) continue;
+
+            ScopedFormatBuffer buffer;
+            std::string& out = buffer.Get();
+            out += separatorString();
+            out += suppressedOutputString();
+            out += '\n';
+            out += fileString();
+            out += pairSeparatorString();
+            out += limiter->GetFileName();
+            out += '\n';
+            out += LineNumberString();
+            out += pairSeparatorString();
+            AppendValue(out, limiter->GetLineNumber());
+            out += '\n';
+            out += functionNameString();
+            out += pairSeparatorString();
+            out += limiter->GetFuncName();
+            out += '\n';
+            out += suppressedCountString();
+            out += pairSeparatorString();
+            AppendValue(out, suppressed);
+            out += '\n';
+            out += separatorString();
+            PrintMessage(out);
+        }
+    }
+
+    /// @brief 前回の表示以降に抑制した回数をメッセージに付け加える。
+    /// メッセージが改行で終わる場合は改行の前に付け加える
+    /// @param message メッセージ本文
+    /// @param suppressed 抑制した回数
+    /// @return 付け加えたメッセージ(抑制がない場合はそのまま)
+    [[nodiscard]] inline std::string AppendSuppressedCount(std::string message, uint64_t suppressed)
+    {
+        if (suppressed == 0) return message;
+
+        const bool endsWithNewline = !message.empty() && message.back() == '\n';
+        if (endsWithNewline) message.pop_back();
+        message += " (";
+        message += suppressedCountString();
+        message += pairSeparatorString();
+        AppendValue(message, suppressed);
+        message += ')';
+        if (endsWithNewline) message += '\n';
+        return message;
+    }
+
+    inline std::string CallSiteLimiter::WithSuppressedCount(std::string message)
+    {
+        return AppendSuppressedCount(std::move(message), TakeSuppressedOnPrint());
+    }
+
+    // 前方宣言
+    class CallSiteThrottle;
+
+    /// @brief 自動で間引かれた呼び出し箇所を登録しておき、間引いた回数の多い箇所を定期的に出力するシングルトンクラス
+    class ThrottleRegistry
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static ThrottleRegistry& GetInstance()
+        {
+            static ThrottleRegistry instance;
+            return instance;
+        }
+
+        /// @brief 呼び出し箇所を登録する。CallSiteThrottle のコンストラクタから一度だけ呼ばれる
+        void Add(CallSiteThrottle* throttle)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Throttles.push_back(throttle);
+        }
+
+        /// @brief 前回の出力から設定した間隔が経過していれば Report() を呼ぶ。
+        /// 間引きが発生した呼び出しから呼ばれ、間隔内は時刻の比較だけで戻る。
+        /// 最初の間引きでは出力せず、その時点から間隔を数え始める
+        /// @param now 現在時刻(ナノ秒)
+        void ReportIfDue(int64_t now)
+        {
+            int64_t next = m_NextReportNs.load(std::memory_order_relaxed);
+            if (next != 0 && now < next) return;
+            const int64_t interval = static_cast<int64_t>(DebugPrintConfig::GetInstance().GetThrottleReportMs()) * 1'000'000;
+            if (!m_NextReportNs.compare_exchange_strong(next, now + interval, std::memory_order_relaxed)) return;
+            if (next != 0) Report();
+        }
+
+        /// @brief 前回の出力以降に間引いた回数が多い呼び出し箇所を上位から出力する
+        inline void Report();
+
+        // コピー・ムーブ禁止
+        ThrottleRegistry(const ThrottleRegistry&) = delete;
+        ThrottleRegistry& operator=(const ThrottleRegistry&) = delete;
+        ThrottleRegistry(ThrottleRegistry&&) = delete;
+        ThrottleRegistry& operator=(ThrottleRegistry&&) = delete;
+
+    private:
+
+        // Report() で出力する呼び出し箇所の数
+        static constexpr std::size_t REPORT_TOP_COUNT = 5;
+
+        /// @brief コンストラクタ。
+        /// 終了時の出力で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+        ThrottleRegistry()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)GetOutputMutex();
+            (void)DuplicateFilter::GetInstance();
+        }
+
+        /// @brief デストラクタ。出力されないまま間引いた回数が残っていれば出力する
+        ~ThrottleRegistry()
+        {
+            Report();
+        }
+
+        std::mutex m_Mutex;  // m_Throttles の排他制御用
+        std::vector<CallSiteThrottle*> m_Throttles;  // 登録された呼び出し箇所
+        std::atomic<int64_t> m_NextReportNs{ 0 };    // 次に ReportIfDue() で出力する時刻(ナノ秒)
+    };
+
+    /// @brief PRINT_MESSAGE・PRINT_WARNING_MESSAGE・PRINT_ERROR_MESSAGE の呼び出し箇所ごとに置かれる出力量の制限。
+    /// 1秒あたりのメッセージ数とバイト数の上限(全呼び出し箇所で共通の設定)を、それぞれ1つのアトミック変数で
+    /// 管理するトークンバケット(GCRA: 次に空きができる理論上の時刻を保持する方式)で判定する。
+    /// 上限を超えた呼び出し箇所は自動で間引かれ、間引いた回数は ThrottleRegistry が定期的に出力する
+    class CallSiteThrottle
+    {
+    public:
+
+        /// @param funcName 呼び出し元の関数名
+        /// @param fileName 呼び出し元のファイル名
+        /// @param lineNumber 呼び出し元の行番号
+        CallSiteThrottle(const char* funcName, const char* fileName, int lineNumber)
+            : m_FuncName(funcName), m_FileName(fileName), m_LineNumber(lineNumber)
+        {
+            ThrottleRegistry::GetInstance().Add(this);
+        }
+
+        /// @brief 表示関数の型。PRINT_MESSAGE などのマクロが表示の種類ごとに渡す
+        using PrintFunction = void (*)(const std::string& message, const char* funcName, const char* fileName, int lineNumber);
+
+        /// @brief このスレッドで最後に AdmitMessage を呼び出した呼び出し箇所を取得する。
+        /// 表示マクロは式として使えるよう状態を名前で参照できないため、メッセージ数の判定の後はこれを使う。
+        /// 判定の直後(メッセージの式を評価する前)に呼び出すこと
+        [[nodiscard]] static CallSiteThrottle& Current() { return *t_Current; }
+
+        /// @brief メッセージ数の上限内かどうかを判定する。メッセージの式を評価する前に呼ばれる
+        /// @return 出力してよい場合は true
+        [[nodiscard]] bool AdmitMessage()
+        {
+            t_Current = this;
+            const uint64_t rate = DebugPrintConfig::GetInstance().GetThrottleMessagesPerSec();
+            if (rate == 0) return true;
+            const int64_t now = GetSteadyNanoseconds();
+            return Admit(m_MessageTat, 1, rate, now) || Throttled(now);
+        }
+
+        /// @brief バイト数の上限内かどうかを判定する。書式化したメッセージの長さで呼ばれる
+        /// @param bytes メッセージのバイト数
+        /// @return 出力してよい場合は true
+        [[nodiscard]] bool AdmitBytes(std::size_t bytes)
+        {
+            const uint64_t rate = DebugPrintConfig::GetInstance().GetThrottleBytesPerSec();
+            if (rate == 0) return true;
+            const int64_t now = GetSteadyNanoseconds();
+            return Admit(m_ByteTat, bytes, rate, now) || Throttled(now);
+        }
+
+        /// @brief 書式化したメッセージがバイト数の上限内の場合に表示する。
+        /// メッセージ数の判定を通った回に PRINT_MESSAGE などのマクロから呼ばれる
+        /// @param message 表示するメッセージ
+        /// @param force 真の場合は上限に関わらず表示する
+        /// @param print 表示関数
+        /// @param funcName 呼び出し元の関数名
+        /// @param fileName 呼び出し元のファイル名
+        /// @param lineNumber 呼び出し元の行番号
+        void Emit(const std::string& message, bool force, PrintFunction print, const char* funcName, const char* fileName, int lineNumber)
+        {
+            if (AdmitBytes(message.size()) || force)
+            {
+                print(message, funcName, fileName, lineNumber);
+            }
+        }
+
+        /// @brief 前回の取得以降に間引いた回数を取得し、0 に戻す
+        [[nodiscard]] uint64_t TakeThrottled() { return m_Throttled.exchange(0, std::memory_order_relaxed); }
+
+        [[nodiscard]] const char* GetFuncName() const { return m_FuncName; }
+        [[nodiscard]] const char* GetFileName() const { return m_FileName; }
+        [[nodiscard]] int GetLineNumber() const { return m_LineNumber; }
+
+        // コピー・ムーブ禁止
+        CallSiteThrottle(const CallSiteThrottle&) = delete;
+        CallSiteThrottle& operator=(const CallSiteThrottle&) = delete;
+        CallSiteThrottle(CallSiteThrottle&&) = delete;
+        CallSiteThrottle& operator=(CallSiteThrottle&&) = delete;
+
+    private:
+
+        /// @brief トークンバケットから cost 分を取り出せるかを判定し、取り出せる場合は理論上の時刻を進める。
+        /// 1秒分(rate 個)までのまとまった出力は許容する。
+        /// バケットが満杯(理論上の時刻が現在以前)の場合は、1秒分を超える大きなメッセージでも1件は許容し、
+        /// その分だけ次に空きができる時刻を先に進める
+        /// @param tat 次に空きができる理論上の時刻(ナノ秒)
+        /// @param cost 取り出す量
+        /// @param rate 1秒あたりの上限
+        /// @param now 現在時刻(ナノ秒)
+        [[nodiscard]] static bool Admit(std::atomic<int64_t>& tat, std::size_t cost, uint64_t rate, int64_t now)
+        {
+            constexpr int64_t burstNs = 1'000'000'000;
+            const int64_t costNs = static_cast<int64_t>(static_cast<double>(cost) * 1e9 / static_cast<double>(rate));
+            int64_t current = tat.load(std::memory_order_relaxed);
+            while (true)
+            {
+                const int64_t next = (std::max)(current, now) + costNs;
+                if (current > now && next - now > burstNs) return false;
+                if (tat.compare_exchange_weak(current, next, std::memory_order_relaxed)) return true;
+            }
+        }
+
+        /// @brief 間引いた回数を数え、必要なら上位の呼び出し箇所を出力する
+        /// @return 常に false
+        bool Throttled(int64_t now)
+        {
+            m_Throttled.fetch_add(1, std::memory_order_relaxed);
+            ThrottleRegistry::GetInstance().ReportIfDue(now);
+            return false;
+        }
+
+        const char* m_FuncName;    // 呼び出し元の関数名
+        const char* m_FileName;    // 呼び出し元のファイル名
+        int         m_LineNumber;  // 呼び出し元の行番号
+        std::atomic<int64_t>  m_MessageTat{ 0 };  // メッセージ数の理論上の空き時刻(ナノ秒)
+        std::atomic<int64_t>  m_ByteTat{ 0 };     // バイト数の理論上の空き時刻(ナノ秒)
+        std::atomic<uint64_t> m_Throttled{ 0 };   // 前回の出力以降に間引いた回数
+
+        static inline thread_local CallSiteThrottle* t_Current = nullptr;  // このスレッドで最後に AdmitMessage を呼び出した呼び出し箇所
+    };
+
+    inline void ThrottleRegistry::Report()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::vector<std::pair<uint64_t, const CallSiteThrottle*>> offenders;
+        for (CallSiteThrottle* throttle : m_Throttles)
+        {
+            const uint64_t throttled = throttle->TakeThrottled();
+            if (throttled > 0) offenders.emplace_back(throttled, throttle);
+        }
+        if (offenders.empty()) return;
+
+        const std::size_t count = (std::min)(offenders.size(), REPORT_TOP_COUNT);
+        std::partial_sort(offenders.begin(), offenders.begin() + static_cast<std::ptrdiff_t>(count), offenders.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        out += separatorString();
+        out += throttledOutputString();
+        out += '\n';
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const CallSiteThrottle* throttle = offenders[i].second;
+            out += fileString();
+            out += pairSeparatorString();
+            out += throttle->GetFileName();
+            out += "  ";
+            out += LineNumberString();
+            out += pairSeparatorString();
+            AppendValue(out, throttle->GetLineNumber());
+            out += "  ";
+            out += functionNameString();
+            out += pairSeparatorString();
+            out += throttle->GetFuncName();
+            out += '\n';
+            out += suppressedCountString();
+            out += pairSeparatorString();
+            AppendValue(out, offenders[i].first);
+            out += '\n';
+        }
+        out += separatorString();
+        PrintMessage(out, DebugPrintConfig::GetInstance().GetPrintWarningMessageColor());
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include "AllocationCounter.h"
+#include "DebugPrintConfig.h"
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+
+namespace DebugPrint
+{
+    /// @brief PRINT_TRACE_FUNCTION を置いた呼び出し箇所1か所分の集計値
+    struct ScopeSiteStats
+    {
+        uint64_t           callCount        = 0;  // 呼び出し回数
+        uint64_t           totalNanoseconds = 0;  // 合計経過時間(ナノ秒)
+        AllocationCounters allocations;           // スコープ内のヒープ確保の合計
+    };
+
+    /// @brief PRINT_TRACE_FUNCTION の計測結果を呼び出し箇所ごとに集計するシングルトンクラス。
+    /// FunctionTracer の終了時に Record() が呼ばれ、関数名・ファイル名・行番号をキーに加算する。
+    /// Report() でまとめて出力でき、設定が有効な場合はプログラム終了時にも出力する
+    class ScopeProfiler
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static ScopeProfiler& GetInstance()
+        {
+            static ScopeProfiler instance;
+            return instance;
+        }
+
+        /// @brief スコープ1回分の計測結果を加算する
+        /// @param funcName 呼び出し元の関数名
+        /// @param fileName 呼び出し元のファイル名
+        /// @param lineNumber 呼び出し元の行番号
+        /// @param elapsedNanoseconds スコープの経過時間(ナノ秒)
+        /// @param allocations スコープ内のヒープ確保数
+        void Record(
+            const char* funcName,
+            const char* fileName,
+            int lineNumber,
+            uint64_t elapsedNanoseconds,
+            const AllocationCounters& allocations)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ScopeSiteStats& stats = m_Sites[SiteKey(funcName, fileName, lineNumber)];
+            ++stats.callCount;
+            stats.totalNanoseconds += elapsedNanoseconds;
+            stats.allocations += allocations;
+        }
+
+        /// @brief 呼び出し箇所ごとの集計結果をコンソールに出力する
+        void Report() const
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (const auto& [key, stats] : m_Sites)
+            {
+                std::ostringstream out;
+                out << separatorString()
+                    << scopeProfileString() << "\n"
+                    << fileString() << pairSeparatorString() << std::get<1>(key) << "\n"
+                    << LineNumberString() << pairSeparatorString() << std::get<2>(key) << "\n"
+                    << functionNameString() << pairSeparatorString() << std::get<0>(key) << "\n"
+                    << callCountString() << pairSeparatorString() << stats.callCount << "\n"
+                    << totalTimeString() << pairSeparatorString()
+                    << static_cast<double>(stats.totalNanoseconds) / 1e9 << secondsString() << "\n";
+                if (IsAllocationTrackingEnabled())
+                {
+                    out << allocCountString() << pairSeparatorString() << stats.allocations.allocCount << "\n"
+                        << allocBytesString() << pairSeparatorString() << stats.allocations.allocBytes << "\n"
+                        << freeCountString() << pairSeparatorString() << stats.allocations.freeCount << "\n";
+                }
+                out << separatorString();
+                PrintMessage(out.str());
+            }
+        }
+
+        /// @brief 集計結果をすべて消去する
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Sites.clear();
+        }
+
+        // コピー・ムーブ禁止
+        ScopeProfiler(const ScopeProfiler&) = delete;
+        ScopeProfiler& operator=(const ScopeProfiler&) = delete;
+        ScopeProfiler(ScopeProfiler&&) = delete;
+        ScopeProfiler& operator=(ScopeProfiler&&) = delete;
+
+    private:
+
+        // 呼び出し箇所のキー(関数名・ファイル名・行番号)
+        using SiteKey = std::tuple<const char*, const char*, int>;
+
+        /// @brief コンストラクタ。
+        /// 終了時の出力で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+        ScopeProfiler()
+        {
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+            (void)DuplicateFilter::GetInstance();
+        }
+
+        /// @brief デストラクタ。設定が有効な場合は集計結果を出力する
+        ~ScopeProfiler()
+        {
+            if (DebugPrintConfig::GetInstance().IsScopeProfileReportEnabled())
+            {
+                Report();
+            }
+        }
+
+        mutable std::mutex m_Mutex;  // m_Sites の排他制御用
+        std::map<SiteKey, ScopeSiteStats> m_Sites;  // 呼び出し箇所ごとの集計値
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
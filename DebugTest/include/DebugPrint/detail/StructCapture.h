@@ -0,0 +1,740 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/pfr.hpp>
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "PrintVariable.h"
+#include "FormatBuffer.h"
+#include "MemoryDump.h"
+#include "TimeUtility.h"
+#include "../third_party/magic_enum/magic_enum.hpp"
+
+namespace DebugPrint
+{
+    // 記録ファイルの先頭に置く識別子と形式のバージョン
+    inline constexpr char     STRUCT_CAPTURE_MAGIC[4]  = { 'D', 'P', 'S', 'C' };
+    inline constexpr uint32_t STRUCT_CAPTURE_VERSION   = 1;
+
+    // 1件の記録の先頭位置と値の長さを揃える境界
+    inline constexpr std::size_t STRUCT_CAPTURE_ALIGNMENT = 8;
+
+    /// @brief 記録したメンバーの値の種類
+    enum class CaptureFieldKind : uint8_t
+    {
+        Bool, Char,
+        Int8, Int16, Int32, Int64,
+        UInt8, UInt16, UInt32, UInt64,
+        Float, Double,
+        Enum,   // 列挙型(値は valueKind の整数、名前は enumEntries)
+        Bytes,  // 上記以外(16進数で表示する)
+    };
+
+    /// @brief 列挙型の値と名前の組
+    struct CaptureEnumEntry
+    {
+        int64_t     value;  // 列挙子の値
+        std::string name;   // 列挙子の名前
+    };
+
+    /// @brief 記録する構造体の末端のメンバー1つ分の情報。
+    /// ネストした構造体は展開し、経路("position.x" など)を名前とする
+    struct CaptureField
+    {
+        std::string      path;                               // 最上位の構造体からの経路
+        uint32_t         offset    = 0;                      // 構造体の先頭からのバイト位置
+        uint32_t         size      = 0;                      // 要素1つのバイト数
+        uint32_t         count     = 1;                      // 要素数(配列の場合のみ2以上)
+        CaptureFieldKind kind      = CaptureFieldKind::Bytes; // 値の種類
+        CaptureFieldKind valueKind = CaptureFieldKind::Bytes; // 列挙型の基底の整数型
+        std::vector<CaptureEnumEntry> enumEntries;           // 列挙型の値と名前の表
+    };
+
+    /// @brief 構造体の型1つ分のスキーマ。記録ファイルに埋め込み、オフラインでの復号に使う
+    struct CaptureSchema
+    {
+        uint32_t                  size = 0;  // 構造体のバイト数
+        std::vector<CaptureField> fields;    // 末端のメンバー(宣言順)
+    };
+
+    /// @brief 記録1件の先頭に置くヘッダー。直後に構造体のバイト列が続く
+    struct CaptureRecordHeader
+    {
+        uint32_t schemaId;     // スキーマの番号
+        uint32_t nameId;       // 変数名の番号
+        uint64_t timestampNs;  // 記録開始からの経過時間(ナノ秒)
+    };
+
+    /// @brief 算術型に対応する値の種類を取得する。対応しない型は Bytes になる
+    template <typename T>
+    [[nodiscard]] constexpr CaptureFieldKind GetScalarKind()
+    {
+        if constexpr (std::is_same_v<T, bool>)            return CaptureFieldKind::Bool;
+        else if constexpr (std::is_same_v<T, char>)       return CaptureFieldKind::Char;
+        else if constexpr (std::is_same_v<T, float>)      return CaptureFieldKind::Float;
+        else if constexpr (std::is_same_v<T, double>)     return CaptureFieldKind::Double;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            if constexpr (sizeof(T) == 1)      return CaptureFieldKind::Int8;
+            else if constexpr (sizeof(T) == 2) return CaptureFieldKind::Int16;
+            else if constexpr (sizeof(T) == 4) return CaptureFieldKind::Int32;
+            else if constexpr (sizeof(T) == 8) return CaptureFieldKind::Int64;
+            else                               return CaptureFieldKind::Bytes;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            if constexpr (sizeof(T) == 1)      return CaptureFieldKind::UInt8;
+            else if constexpr (sizeof(T) == 2) return CaptureFieldKind::UInt16;
+            else if constexpr (sizeof(T) == 4) return CaptureFieldKind::UInt32;
+            else if constexpr (sizeof(T) == 8) return CaptureFieldKind::UInt64;
+            else                               return CaptureFieldKind::Bytes;
+        }
+        else
+        {
+            return CaptureFieldKind::Bytes;
+        }
+    }
+
+    /// @brief std::array かどうかを判定する
+    template <typename T>
+    struct is_std_array : std::false_type {};
+
+    template <typename T, std::size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+
+    /// @brief 要素の型から値の種類を設定する。列挙型は magic_enum で名前の表を作る
+    template <typename E>
+    void SetCaptureElementKind(CaptureField& field)
+    {
+        field.size = static_cast<uint32_t>(sizeof(E));
+        if constexpr (std::is_enum_v<E>)
+        {
+            field.kind      = CaptureFieldKind::Enum;
+            field.valueKind = GetScalarKind<std::underlying_type_t<E>>();
+            for (const auto& [value, name] : magic_enum::enum_entries<E>())
+            {
+                field.enumEntries.push_back({ static_cast<int64_t>(value), std::string(name) });
+            }
+        }
+        else
+        {
+            field.kind = GetScalarKind<E>();
+        }
+    }
+
+    // 前方宣言
+    template <typename Field>
+    void AddCaptureField(CaptureSchema& schema, const Field& value, const std::byte* base, std::string& path, std::string_view memberName);
+
+    /// @brief 構造体のメンバーを Boost.PFR で走査し、末端のメンバーをスキーマに追加する。
+    /// バイト位置は実際の変数のメンバーのアドレスから求める
+    /// @param schema 追加先のスキーマ
+    /// @param value 走査する構造体(またはネストしたメンバー)
+    /// @param base 最上位の構造体の先頭アドレス
+    /// @param path 親の構造体までの経路
+    template <typename U>
+    void AddCaptureFields(CaptureSchema& schema, const U& value, const std::byte* base, std::string& path)
+    {
+        constexpr auto memberNames = boost::pfr::names_as_array<U>();
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            (AddCaptureField(schema, boost::pfr::get<I>(value), base, path, memberNames[I]), ...);
+        }(std::make_index_sequence<boost::pfr::tuple_size_v<U>>{});
+    }
+
+    /// @brief メンバー1つをスキーマに追加する。集成体のメンバーは再帰的に展開する
+    template <typename Field>
+    void AddCaptureField(CaptureSchema& schema, const Field& value, const std::byte* base, std::string& path, std::string_view memberName)
+    {
+        const std::size_t parentLength = path.size();
+        if (parentLength > 0) path += '.';
+        path += memberName;
+
+        if constexpr (is_reflectable<Field>::value)
+        {
+            AddCaptureFields(schema, value, base, path);
+        }
+        else
+        {
+            CaptureField field;
+            field.path   = path;
+            field.offset = static_cast<uint32_t>(reinterpret_cast<const std::byte*>(std::addressof(value)) - base);
+
+            if constexpr (std::is_array_v<Field>)
+            {
+                SetCaptureElementKind<std::remove_cv_t<std::remove_all_extents_t<Field>>>(field);
+                field.count = static_cast<uint32_t>(sizeof(Field) / field.size);
+            }
+            else if constexpr (is_std_array<Field>::value)
+            {
+                field.count = static_cast<uint32_t>(std::tuple_size_v<Field>);
+                SetCaptureElementKind<typename Field::value_type>(field);
+            }
+            else
+            {
+                SetCaptureElementKind<Field>(field);
+            }
+
+            // 1要素ずつ表示できない型はメンバー全体をバイト列として扱う
+            if (field.kind == CaptureFieldKind::Bytes)
+            {
+                field.size  = static_cast<uint32_t>(sizeof(Field));
+                field.count = 1;
+            }
+            schema.fields.push_back(std::move(field));
+        }
+
+        path.resize(parentLength);
+    }
+
+    /// @brief PRINT_STRUCT の記録モードで、トリビアルにコピー可能な構造体のバイト列をそのまま蓄積するシングルトンクラス。
+    /// 型ごとのスキーマ(メンバーの経路・バイト位置・型・列挙型の名前の表)は初回の記録時に Boost.PFR から一度だけ作り、
+    /// 以降の記録はヘッダーとバイト列の memcpy だけで済む。
+    /// WriteToFile() でスキーマとともに書き出したファイルは DecodeStructCapture() で後から表示できる
+    class StructCapture
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static StructCapture& GetInstance()
+        {
+            static StructCapture instance;
+            return instance;
+        }
+
+        /// @brief 構造体のバイト列を記録する。
+        /// 蓄積した記録が上限のバイト数に達している場合は記録せず、最初の1回だけ警告を表示する
+        /// @param name 変数名の文字列(マクロが渡す文字列リテラル)
+        /// @param var 記録する構造体
+        template <typename T>
+        void Capture(const char* name, const T& var)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && is_reflectable<T>::value,
+                "構造体の記録はトリビアルにコピー可能な集成体のみ対応しています");
+
+            const uint64_t timestampNs = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count());
+
+            constexpr std::size_t recordBytes = sizeof(CaptureRecordHeader) + AlignCaptureSize(sizeof(T));
+            const std::size_t maxBytes = DebugPrintConfig::GetInstance().GetStructCaptureMaxBytes();
+
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            if (maxBytes > 0 && m_Records.size() + recordBytes > maxBytes)
+            {
+                if (m_DroppedCount++ > 0) return;
+                lock.unlock();
+
+                ScopedFormatBuffer buffer;
+                std::string& out = buffer.Get();
+                out += captureLimitReachedString();
+                out += pairSeparatorString();
+                AppendValue(out, maxBytes);
+                out += '\n';
+                PrintMessage(out, DebugPrintConfig::GetInstance().GetPrintWarningMessageColor());
+                return;
+            }
+
+            static const uint32_t schemaId = RegisterSchema(var);
+
+            const CaptureRecordHeader header = { schemaId, GetNameId(name), timestampNs };
+            const std::size_t offset = m_Records.size();
+            m_Records.resize(offset + recordBytes);
+            std::memcpy(m_Records.data() + offset, &header, sizeof(header));
+            std::memcpy(m_Records.data() + offset + sizeof(header), &var, sizeof(T));
+            ++m_RecordCount;
+        }
+
+        /// @brief 蓄積した記録をスキーマとともにファイルに書き出す。
+        /// ファイル名は呼び出し時の日時で自動生成される。
+        /// 出力先ディレクトリが存在しない場合は自動的に作成する。
+        /// 書き出し後も記録は保持される
+        /// @param logPath 出力先ディレクトリパス
+        /// @return 書き出したファイルのパス。失敗した場合は空文字列
+        std::string WriteToFile(const std::string& logPath)
+        {
+            std::filesystem::path dirPath(logPath);
+            if (!std::filesystem::exists(dirPath))
+            {
+                std::filesystem::create_directories(dirPath);
+            }
+
+            const std::string filePath = logPath + GetDateTimeString("%Y-%m-%d_%H-%M-%S") + ".dpsc";
+            std::ofstream file(filePath, std::ios::out | std::ios::trunc | std::ios::binary);
+            if (!file.is_open())
+            {
+                return {};
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            std::vector<std::byte> header;
+            SerializeHeader(header);
+            file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+            file.write(reinterpret_cast<const char*>(m_Records.data()), static_cast<std::streamsize>(m_Records.size()));
+            return file ? filePath : std::string();
+        }
+
+        /// @brief 蓄積した記録をすべて消去する。スキーマと変数名の表は保持する
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Records.clear();
+            m_RecordCount  = 0;
+            m_DroppedCount = 0;
+        }
+
+        /// @brief 蓄積されている記録の件数を取得する
+        [[nodiscard]] std::size_t GetRecordCount()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_RecordCount;
+        }
+
+        /// @brief 上限のバイト数に達したために破棄した記録の件数を取得する
+        [[nodiscard]] std::size_t GetDroppedCount()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_DroppedCount;
+        }
+
+        // コピー・ムーブ禁止
+        StructCapture(const StructCapture&) = delete;
+        StructCapture& operator=(const StructCapture&) = delete;
+        StructCapture(StructCapture&&) = delete;
+        StructCapture& operator=(StructCapture&&) = delete;
+
+    private:
+
+        StructCapture() : m_Start(std::chrono::steady_clock::now()) {}
+
+        /// @brief バイト数を記録の境界に揃える
+        [[nodiscard]] static constexpr std::size_t AlignCaptureSize(std::size_t size)
+        {
+            return (size + STRUCT_CAPTURE_ALIGNMENT - 1) / STRUCT_CAPTURE_ALIGNMENT * STRUCT_CAPTURE_ALIGNMENT;
+        }
+
+        /// @brief 型のスキーマを作って登録する。型ごとに初回の記録時に一度だけ呼ばれる
+        /// @return スキーマの番号
+        template <typename T>
+        uint32_t RegisterSchema(const T& var)
+        {
+            CaptureSchema schema;
+            schema.size = static_cast<uint32_t>(sizeof(T));
+            std::string path;
+            AddCaptureFields(schema, var, reinterpret_cast<const std::byte*>(std::addressof(var)), path);
+            m_Schemas.push_back(std::move(schema));
+            return static_cast<uint32_t>(m_Schemas.size() - 1);
+        }
+
+        /// @brief 変数名の番号を取得する。マクロが渡す文字列リテラルはアドレスで識別する
+        uint32_t GetNameId(const char* name)
+        {
+            const auto [it, inserted] = m_NameIds.try_emplace(name, static_cast<uint32_t>(m_Names.size()));
+            if (inserted)
+            {
+                m_Names.emplace_back(name);
+            }
+            return it->second;
+        }
+
+        /// @brief 値をバイト列の末尾に追加する
+        template <typename T>
+        static void Put(std::vector<std::byte>& out, const T& value)
+        {
+            const std::size_t offset = out.size();
+            out.resize(offset + sizeof(T));
+            std::memcpy(out.data() + offset, &value, sizeof(T));
+        }
+
+        /// @brief 文字列を長さ付きでバイト列の末尾に追加する
+        static void PutString(std::vector<std::byte>& out, std::string_view text)
+        {
+            Put(out, static_cast<uint32_t>(text.size()));
+            const auto* bytes = reinterpret_cast<const std::byte*>(text.data());
+            out.insert(out.end(), bytes, bytes + text.size());
+        }
+
+        /// @brief 記録の前に置く部分(識別子・スキーマ・変数名の表・記録のバイト数)を組み立てる
+        void SerializeHeader(std::vector<std::byte>& out) const
+        {
+            const auto* magic = reinterpret_cast<const std::byte*>(STRUCT_CAPTURE_MAGIC);
+            out.insert(out.end(), magic, magic + sizeof(STRUCT_CAPTURE_MAGIC));
+            Put(out, STRUCT_CAPTURE_VERSION);
+
+            Put(out, static_cast<uint32_t>(m_Schemas.size()));
+            for (const CaptureSchema& schema : m_Schemas)
+            {
+                Put(out, schema.size);
+                Put(out, static_cast<uint32_t>(schema.fields.size()));
+                for (const CaptureField& field : schema.fields)
+                {
+                    PutString(out, field.path);
+                    Put(out, field.offset);
+                    Put(out, field.size);
+                    Put(out, field.count);
+                    Put(out, field.kind);
+                    Put(out, field.valueKind);
+                    Put(out, static_cast<uint32_t>(field.enumEntries.size()));
+                    for (const CaptureEnumEntry& entry : field.enumEntries)
+                    {
+                        Put(out, entry.value);
+                        PutString(out, entry.name);
+                    }
+                }
+            }
+
+            Put(out, static_cast<uint32_t>(m_Names.size()));
+            for (const std::string& name : m_Names)
+            {
+                PutString(out, name);
+            }
+
+            Put(out, static_cast<uint64_t>(m_Records.size()));
+        }
+
+        std::mutex m_Mutex;  // 全メンバーの排他制御用
+        std::chrono::steady_clock::time_point m_Start;  // 記録の経過時間の基準
+        std::vector<CaptureSchema> m_Schemas;  // 登録済みのスキーマ(番号順)
+        std::vector<std::string> m_Names;      // 変数名(番号順)
+        std::unordered_map<const char*, uint32_t> m_NameIds;  // 変数名の文字列リテラルから番号への表
+        std::vector<std::byte> m_Records;      // ヘッダーとバイト列を連続して並べた記録
+        std::size_t m_RecordCount = 0;         // 記録の件数
+        std::size_t m_DroppedCount = 0;        // 上限に達したために破棄した記録の件数
+    };
+
+    /// @brief 記録ファイルを先頭から読み進めるカーソル。範囲外を読もうとした場合は失敗状態になる
+    struct CaptureReader
+    {
+        const std::byte* current;  // 次に読む位置
+        const std::byte* end;      // 末尾
+        bool             ok = true;  // 範囲外を読もうとしていないかどうか
+
+        /// @brief 値を1つ読む
+        template <typename T>
+        T Read()
+        {
+            T value{};
+            if (static_cast<std::size_t>(end - current) < sizeof(T))
+            {
+                ok = false;
+                current = end;
+                return value;
+            }
+            std::memcpy(&value, current, sizeof(T));
+            current += sizeof(T);
+            return value;
+        }
+
+        /// @brief 要素数を1つ読む。
+        /// 各要素が少なくとも minItemBytes バイトを占めるとして残りのバイト数に収まらない場合は、
+        /// 確保する前に失敗状態にして 0 を返す
+        /// @param minItemBytes 1要素がファイル上で占める最小のバイト数
+        std::size_t ReadCount(std::size_t minItemBytes)
+        {
+            const uint32_t count = Read<uint32_t>();
+            if (static_cast<std::size_t>(end - current) / minItemBytes < count)
+            {
+                ok = false;
+                current = end;
+                return 0;
+            }
+            return count;
+        }
+
+        /// @brief 長さ付きの文字列を1つ読む
+        std::string ReadString()
+        {
+            const uint32_t length = Read<uint32_t>();
+            if (static_cast<std::size_t>(end - current) < length)
+            {
+                ok = false;
+                current = end;
+                return {};
+            }
+            std::string text(reinterpret_cast<const char*>(current), length);
+            current += length;
+            return text;
+        }
+    };
+
+    /// @brief 値の種類ごとの要素1つのバイト数を取得する
+    /// @return 固定長の種類はそのバイト数、Enum・Bytes・不明な値は 0
+    [[nodiscard]] constexpr std::size_t GetCaptureKindSize(CaptureFieldKind kind)
+    {
+        switch (kind)
+        {
+        case CaptureFieldKind::Bool:   return sizeof(bool);
+        case CaptureFieldKind::Char:   return sizeof(char);
+        case CaptureFieldKind::Int8:   return sizeof(int8_t);
+        case CaptureFieldKind::Int16:  return sizeof(int16_t);
+        case CaptureFieldKind::Int32:  return sizeof(int32_t);
+        case CaptureFieldKind::Int64:  return sizeof(int64_t);
+        case CaptureFieldKind::UInt8:  return sizeof(uint8_t);
+        case CaptureFieldKind::UInt16: return sizeof(uint16_t);
+        case CaptureFieldKind::UInt32: return sizeof(uint32_t);
+        case CaptureFieldKind::UInt64: return sizeof(uint64_t);
+        case CaptureFieldKind::Float:  return sizeof(float);
+        case CaptureFieldKind::Double: return sizeof(double);
+        default:                       return 0;
+        }
+    }
+
+    /// @brief メンバーの要素1つのバイト数が値の種類と一致するかどうかを判定する。
+    /// 復号時は種類に応じたバイト数を読むため、ファイルに書かれた size と食い違うと記録の範囲外を読んでしまう。
+    /// 任意のバイト数を持てるのは Bytes のみで、Enum は基底の整数型(valueKind)のバイト数と比べる
+    [[nodiscard]] inline bool IsCaptureFieldSizeValid(const CaptureField& field)
+    {
+        if (field.kind == CaptureFieldKind::Bytes)
+        {
+            return true;
+        }
+        if (field.kind == CaptureFieldKind::Enum)
+        {
+            // 列挙型の基底は整数型のみ
+            const bool integral = field.valueKind >= CaptureFieldKind::Char && field.valueKind <= CaptureFieldKind::UInt64;
+            return integral && GetCaptureKindSize(field.valueKind) == field.size;
+        }
+        const std::size_t kindSize = GetCaptureKindSize(field.kind);
+        return kindSize != 0 && kindSize == field.size;
+    }
+
+    /// @brief 記録したバイト列から値を1つ読み、PRINT_STRUCT と同じ書式で追加する
+    /// @param out 追加先のバッファ
+    /// @param kind 値の種類
+    /// @param bytes 値の先頭
+    /// @param size 値のバイト数(Bytes の場合のみ使う)
+    inline void AppendCapturedScalar(std::string& out, CaptureFieldKind kind, const std::byte* bytes, std::size_t size)
+    {
+        const auto append = [&]<typename T>(T value)
+        {
+            std::memcpy(&value, bytes, sizeof(T));
+            AppendValue(out, value);
+        };
+
+        switch (kind)
+        {
+        case CaptureFieldKind::Bool:   append(bool{});     break;
+        case CaptureFieldKind::Char:   append(char{});     break;
+        case CaptureFieldKind::Int8:   append(int8_t{});   break;
+        case CaptureFieldKind::Int16:  append(int16_t{});  break;
+        case CaptureFieldKind::Int32:  append(int32_t{});  break;
+        case CaptureFieldKind::Int64:  append(int64_t{});  break;
+        case CaptureFieldKind::UInt8:  append(uint8_t{});  break;
+        case CaptureFieldKind::UInt16: append(uint16_t{}); break;
+        case CaptureFieldKind::UInt32: append(uint32_t{}); break;
+        case CaptureFieldKind::UInt64: append(uint64_t{}); break;
+        case CaptureFieldKind::Float:  append(float{});    break;
+        case CaptureFieldKind::Double: append(double{});   break;
+        default:
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                out.append(HEX_PAIRS.data() + static_cast<uint8_t>(bytes[i]) * 2, 2);
+            }
+            break;
+        }
+    }
+
+    /// @brief 記録したバイト列から整数を読み、int64_t に広げて返す(列挙型の値の照合用)
+    [[nodiscard]] inline int64_t ReadCapturedInteger(CaptureFieldKind kind, const std::byte* bytes)
+    {
+        const auto read = [&]<typename T>(T value) -> int64_t
+        {
+            std::memcpy(&value, bytes, sizeof(T));
+            return static_cast<int64_t>(value);
+        };
+
+        switch (kind)
+        {
+        case CaptureFieldKind::Char:   return read(char{});
+        case CaptureFieldKind::Int8:   return read(int8_t{});
+        case CaptureFieldKind::Int16:  return read(int16_t{});
+        case CaptureFieldKind::Int32:  return read(int32_t{});
+        case CaptureFieldKind::Int64:  return read(int64_t{});
+        case CaptureFieldKind::UInt8:  return read(uint8_t{});
+        case CaptureFieldKind::UInt16: return read(uint16_t{});
+        case CaptureFieldKind::UInt32: return read(uint32_t{});
+        case CaptureFieldKind::UInt64: return read(uint64_t{});
+        default:                       return 0;
+        }
+    }
+
+    /// @brief 記録したメンバー1つの値を追加する。配列は "[a, b, c]" の形式にする
+    inline void AppendCapturedField(std::string& out, const CaptureField& field, const std::byte* record)
+    {
+        if (field.count > 1) out += '[';
+        for (uint32_t i = 0; i < field.count; ++i)
+        {
+            if (i > 0) out += ", ";
+            const std::byte* bytes = record + field.offset + static_cast<std::size_t>(i) * field.size;
+            if (field.kind != CaptureFieldKind::Enum)
+            {
+                AppendCapturedScalar(out, field.kind, bytes, field.size);
+                continue;
+            }
+
+            const int64_t value = ReadCapturedInteger(field.valueKind, bytes);
+            bool found = false;
+            for (const CaptureEnumEntry& entry : field.enumEntries)
+            {
+                if (entry.value == value)
+                {
+                    out += entry.name;
+                    found = true;
+                    break;
+                }
+            }
+            // 名前の表にない値は数値で表示する
+            if (!found) AppendValue(out, value);
+        }
+        if (field.count > 1) out += ']';
+    }
+
+    /// @brief 記録ファイルを読み込み、全記録を PRINT_STRUCT と同じ書式の文字列に復元する。
+    /// ファイルに埋め込まれたスキーマだけを使うため、記録した実行ファイルがなくても復元できる
+    /// @param filePath StructCapture::WriteToFile() が書き出したファイルのパス
+    /// @param out 復元した文字列の追加先
+    /// @return 読み込みに成功した場合は true、ファイルがない・形式が異なる場合は false
+    inline bool DecodeStructCapture(const std::string& filePath, std::string& out)
+    {
+        std::ifstream file(filePath, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        CaptureReader reader{ reinterpret_cast<const std::byte*>(data.data()), reinterpret_cast<const std::byte*>(data.data() + data.size()) };
+        const auto magic = reader.Read<std::array<char, 4>>();
+        if (std::memcmp(magic.data(), STRUCT_CAPTURE_MAGIC, sizeof(STRUCT_CAPTURE_MAGIC)) != 0 ||
+            reader.Read<uint32_t>() != STRUCT_CAPTURE_VERSION)
+        {
+            return false;
+        }
+
+        // 要素数はファイルの値をそのまま信用せず、残りのバイト数に収まる場合のみ確保する。
+        // 各要素の最小のバイト数は SerializeHeader が書き出す固定長の部分の大きさ
+        constexpr std::size_t minSchemaBytes = sizeof(uint32_t) * 2;
+        constexpr std::size_t minFieldBytes  = sizeof(uint32_t) * 5 + sizeof(CaptureFieldKind) * 2;
+        constexpr std::size_t minEnumBytes   = sizeof(int64_t) + sizeof(uint32_t);
+        constexpr std::size_t minNameBytes   = sizeof(uint32_t);
+
+        std::vector<CaptureSchema> schemas(reader.ReadCount(minSchemaBytes));
+        if (!reader.ok) return false;
+        for (CaptureSchema& schema : schemas)
+        {
+            schema.size = reader.Read<uint32_t>();
+            schema.fields.resize(reader.ReadCount(minFieldBytes));
+            for (CaptureField& field : schema.fields)
+            {
+                field.path      = reader.ReadString();
+                field.offset    = reader.Read<uint32_t>();
+                field.size      = reader.Read<uint32_t>();
+                field.count     = reader.Read<uint32_t>();
+                field.kind      = reader.Read<CaptureFieldKind>();
+                field.valueKind = reader.Read<CaptureFieldKind>();
+                field.enumEntries.resize(reader.ReadCount(minEnumBytes));
+                for (CaptureEnumEntry& entry : field.enumEntries)
+                {
+                    entry.value = reader.Read<int64_t>();
+                    entry.name  = reader.ReadString();
+                }
+                if (!IsCaptureFieldSizeValid(field) ||
+                    static_cast<uint64_t>(field.offset) + static_cast<uint64_t>(field.size) * field.count > schema.size)
+                {
+                    return false;
+                }
+            }
+            if (!reader.ok) return false;
+        }
+
+        std::vector<std::string> names(reader.ReadCount(minNameBytes));
+        for (std::string& name : names)
+        {
+            name = reader.ReadString();
+        }
+
+        const uint64_t recordBytes = reader.Read<uint64_t>();
+        if (!reader.ok || static_cast<uint64_t>(reader.end - reader.current) < recordBytes)
+        {
+            return false;
+        }
+        reader.end = reader.current + recordBytes;
+
+        while (reader.current < reader.end)
+        {
+            const CaptureRecordHeader header = reader.Read<CaptureRecordHeader>();
+            if (!reader.ok || header.schemaId >= schemas.size() || header.nameId >= names.size())
+            {
+                return false;
+            }
+            const CaptureSchema& schema = schemas[header.schemaId];
+            // 32ビットの範囲で境界に揃えると桁あふれで小さくなるため、64ビットで求める
+            const uint64_t recordSize = (static_cast<uint64_t>(schema.size) + STRUCT_CAPTURE_ALIGNMENT - 1) / STRUCT_CAPTURE_ALIGNMENT * STRUCT_CAPTURE_ALIGNMENT;
+            if (static_cast<uint64_t>(reader.end - reader.current) < recordSize)
+            {
+                return false;
+            }
+
+            out += separatorString();
+            out += variableString();
+            out += pairSeparatorString();
+            out += names[header.nameId];
+            out += '\n';
+            out += captureTimeString();
+            out += pairSeparatorString();
+            char buffer[32];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer),
+                static_cast<double>(header.timestampNs) / 1e9, std::chars_format::fixed, 6);
+            out.append(buffer, result.ptr);
+            out += secondsString();
+            out += '\n';
+            for (const CaptureField& field : schema.fields)
+            {
+                out += variableString();
+                out += pairSeparatorString();
+                out += field.path;
+                out += "  ";
+                out += valueString();
+                out += pairSeparatorString();
+                AppendCapturedField(out, field, reader.current);
+                out += '\n';
+            }
+            out += separatorString();
+            reader.current += recordSize;
+        }
+        return true;
+    }
+
+    /// @brief 記録ファイルを復元してコンソールに表示する。
+    /// 読み込めない場合はエラーメッセージを表示する
+    /// @param filePath 記録ファイルのパス
+    inline void PrintStructCapture(const std::string& filePath)
+    {
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        if (!DecodeStructCapture(filePath, out))
+        {
+            out.clear();
+            out += captureReadFailedString();
+            out += pairSeparatorString();
+            out += filePath;
+            PrintMessage(out, PRINT_COLOR::BRIGHT_RED);
+            return;
+        }
+        PrintMessage(out);
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
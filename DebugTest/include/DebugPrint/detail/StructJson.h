@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <boost/pfr.hpp>
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "PrintVariable.h"
+#include "FormatBuffer.h"
+#include "../third_party/rapidjson/writer.h"
+#include "../third_party/magic_enum/magic_enum.hpp"
+
+namespace DebugPrint
+{
+    /// @brief std::string の末尾に直接書き込む RapidJSON の出力ストリーム。
+    /// DOM や std::ostringstream を介さず、Writer の出力を既存のバッファに追記する
+    class JsonStringStream
+    {
+    public:
+        using Ch = char;
+
+        explicit JsonStringStream(std::string& out) : m_Out(out) {}
+
+        /// @brief 1文字追加する
+        void Put(Ch c) { m_Out.push_back(c); }
+
+        /// @brief 追加する文字数の分だけ先に領域を確保する。
+        /// 数値や文字列の書き込み前に Writer から呼ばれ、再確保の回数を抑える
+        void Reserve(std::size_t count)
+        {
+            const std::size_t required = m_Out.size() + count;
+            if (required > m_Out.capacity())
+            {
+                m_Out.reserve((std::max)(required, m_Out.capacity() * 2));
+            }
+        }
+
+        /// @brief 書き込み先が std::string のため何もしない
+        void Flush() {}
+
+    private:
+        std::string& m_Out;  // 書き込み先のバッファ
+    };
+
+    /// @brief Writer が数値や文字列の前に呼ぶ領域確保を JsonStringStream に伝える。
+    /// Writer 内の修飾なしの呼び出しから実引数依存の名前探索で見つかる
+    inline void PutReserve(JsonStringStream& stream, std::size_t count)
+    {
+        stream.Reserve(count);
+    }
+
+    /// @brief JSON の書き出しに使う Writer の型。NaN と無限大は JSON にないため null で書き出す
+    template <typename OutputStream>
+    using JsonWriter = rapidjson::Writer<
+        OutputStream,
+        rapidjson::UTF8<>,
+        rapidjson::UTF8<>,
+        rapidjson::CrtAllocator,
+        rapidjson::kWriteNanAndInfNullFlag>;
+
+    /// @brief キーが文字列の連想コンテナ(JSON のオブジェクトとして書き出せる型)かどうかを判定する
+    template <typename T>
+    concept StringKeyedMapRange = MapLikeRange<T> && StringLike<typename T::key_type>;
+
+    // 前方宣言
+    template <typename Writer, typename T>
+    void WriteJsonValue(Writer& writer, const T& value);
+
+    /// @brief 集成体のメンバーを Boost.PFR で走査し、メンバー名をキーとするオブジェクトとして書き出す。
+    /// メンバー名はコンパイル時の文字列をそのまま渡すため、複製や長さの計算は行わない
+    template <typename Writer, typename T>
+    void WriteJsonObject(Writer& writer, const T& value)
+    {
+        constexpr auto memberNames = boost::pfr::names_as_array<T>();
+        writer.StartObject();
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            ((writer.Key(memberNames[I].data(), static_cast<rapidjson::SizeType>(memberNames[I].size())),
+              WriteJsonValue(writer, boost::pfr::get<I>(value))), ...);
+        }(std::make_index_sequence<boost::pfr::tuple_size_v<T>>{});
+        writer.EndObject();
+    }
+
+    /// @brief 値の型に応じて JSON の値を1つ書き出す。
+    /// 集成体はオブジェクト、範囲とタプルは配列、キーが文字列の連想コンテナはオブジェクト、
+    /// 列挙型は magic_enum で得た名前の文字列として書き出す。
+    /// 対応する表現がない型は PRINT_VARIABLE と同じ書式の文字列にする
+    /// @param writer 書き出し先の Writer
+    /// @param value 書き出す値
+    template <typename Writer, typename T>
+    void WriteJsonValue(Writer& writer, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            writer.Bool(value);
+        }
+        else if constexpr (std::is_same_v<T, char>)
+        {
+            writer.String(&value, 1);
+        }
+        else if constexpr (std::is_same_v<T, float>)
+        {
+            // double に広げると 0.1f が 0.10000000149011612 になるため、float の最短表現で書き出す
+            if (!std::isfinite(value))
+            {
+                writer.Null();
+                return;
+            }
+            char buffer[32];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            writer.RawValue(buffer, static_cast<std::size_t>(result.ptr - buffer), rapidjson::kNumberType);
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            writer.Double(static_cast<double>(value));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            writer.Int64(static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            writer.Uint64(static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            const auto name = magic_enum::enum_name(value);
+            if (name.empty())
+            {
+                // magic_enum の範囲外の値は数値で書き出す
+                WriteJsonValue(writer, static_cast<std::underlying_type_t<T>>(value));
+            }
+            else
+            {
+                writer.String(name.data(), static_cast<rapidjson::SizeType>(name.size()));
+            }
+        }
+        else if constexpr (std::is_null_pointer_v<T>)
+        {
+            writer.Null();
+        }
+        else if constexpr (StringLike<T>)
+        {
+            const std::string_view text = ToStringView(value);
+            writer.String(text.data(), static_cast<rapidjson::SizeType>(text.size()));
+        }
+        else if constexpr (is_optional<T>::value)
+        {
+            if (value)
+            {
+                WriteJsonValue(writer, *value);
+            }
+            else
+            {
+                writer.Null();
+            }
+        }
+        else if constexpr (is_variant<T>::value)
+        {
+            if (value.valueless_by_exception())
+            {
+                writer.Null();
+                return;
+            }
+            std::visit([&](const auto& alternative) { WriteJsonValue(writer, alternative); }, value);
+        }
+        else if constexpr (is_reflectable<T>::value)
+        {
+            WriteJsonObject(writer, value);
+        }
+        else if constexpr (StringKeyedMapRange<T>)
+        {
+            writer.StartObject();
+            for (const auto& [key, mapped] : value)
+            {
+                const std::string_view text(key);
+                writer.Key(text.data(), static_cast<rapidjson::SizeType>(text.size()));
+                WriteJsonValue(writer, mapped);
+            }
+            writer.EndObject();
+        }
+        else if constexpr (PrintableRange<T>)
+        {
+            // キーが文字列でない連想コンテナは [キー, 値] の配列の配列になる
+            writer.StartArray();
+            for (const auto& element : value)
+            {
+                WriteJsonValue(writer, element);
+            }
+            writer.EndArray();
+        }
+        else if constexpr (TupleLike<T>)
+        {
+            writer.StartArray();
+            std::apply([&](const auto&... elements) { (WriteJsonValue(writer, elements), ...); }, value);
+            writer.EndArray();
+        }
+        else
+        {
+            std::string text;
+            AppendFormatted(text, value, 0, GetPrintLimits());
+            writer.String(text.data(), static_cast<rapidjson::SizeType>(text.size()));
+        }
+    }
+
+    /// @brief 構造体を1行の JSON として RapidJSON の出力ストリームに直接書き出す。
+    /// Writer はスレッドごとに再利用するため、毎回の生成と内部スタックの確保は行わない。
+    /// 多数の構造体をまとめて書き出す場合は JsonWriter を自分で用意して WriteJsonValue を呼ぶとよい
+    /// @param os 書き出し先のストリーム(RapidJSON の出力ストリームの要件を満たす型)
+    /// @param var 書き出す構造体
+    template <typename OutputStream, typename T>
+    void WriteStructJson(OutputStream& os, const T& var)
+    {
+        thread_local JsonWriter<OutputStream> writer;
+        writer.Reset(os);
+        WriteJsonValue(writer, var);
+        writer.Flush();
+    }
+
+    /// @brief 構造体を1行の JSON としてバッファの末尾に追加する
+    /// @param out 追加先のバッファ
+    /// @param var 書き出す構造体
+    template <typename T>
+    void AppendStructJson(std::string& out, const T& var)
+    {
+        JsonStringStream stream(out);
+        WriteStructJson(stream, var);
+    }
+
+    /// @brief 構造体名とメンバーを JSON でコンソールに表示する。
+    /// PRINT_STRUCT_JSON マクロから呼び出される
+    /// @param name 構造体変数名の文字列
+    /// @param var 表示する構造体
+    /// @param color 表示色
+    template <typename T>
+    void PrintStructJson(const char* name, const T& var, Color color = PRINT_COLOR::DEFAULT)
+    {
+        static_assert(is_reflectable<T>::value,
+            "PRINT_STRUCT_JSON は集成体(継承なし・仮想関数なし・ユーザー定義コンストラクタなし)のみ対応しています");
+
+        ScopedFormatBuffer buffer;
+        std::string& out = buffer.Get();
+        out += separatorString();
+        out += variableString();
+        out += pairSeparatorString();
+        out += name;
+        out += '\n';
+        AppendStructJson(out, var);
+        out += '\n';
+        out += separatorString();
+        PrintMessage(out, color);
+    }
+
+} // namespace DebugPrint
\ No newline at end of file
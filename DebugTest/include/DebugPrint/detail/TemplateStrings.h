@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <fstream>
@@ -56,6 +58,7 @@ namespace DebugPrint
                 return;
             }
             it->second = value;
+            m_Generation.fetch_add(1, std::memory_order_relaxed);
         }
 
         /// @brief キーに対応する文字列を取得する。
@@ -71,6 +74,11 @@ namespace DebugPrint
             return key;
         }
 
+        /// @brief 文字列テーブルの世代番号を取得する。
+        /// 言語の切り替えや文字列の変更のたびに増加するため、
+        /// 文字列から組み立てたキャッシュの再構築が必要かどうかの判定に使う
+        [[nodiscard]] uint64_t GetGeneration() const { return m_Generation.load(std::memory_order_relaxed); }
+
         // コピー・ムーブ禁止
         TemplateStrings(const TemplateStrings&) = delete;
         TemplateStrings& operator=(const TemplateStrings&) = delete;
@@ -90,6 +98,7 @@ namespace DebugPrint
         void LoadLanguageFile()
         {
             m_Strings.clear();
+            m_Generation.fetch_add(1, std::memory_order_relaxed);
 
             const std::string filePath = m_LanguagePath + m_Language + ".json";
 
@@ -143,12 +152,56 @@ namespace DebugPrint
             m_Strings["open"] = "[";
             m_Strings["close"] = "]";
             m_Strings["errorDialogTitle"] = "エラー";
+            m_Strings["classReport"] = "クラス統計";
+            m_Strings["liveCount"] = "生存数";
+            m_Strings["peakCount"] = "最大生存数";
+            m_Strings["totalConstructed"] = "累計生成数";
+            m_Strings["lifetimeHistogram"] = "寿命の分布";
+            m_Strings["leakDetected"] = "未破棄のインスタンス";
+            m_Strings["scopeProfile"] = "スコープ統計";
+            m_Strings["callCount"] = "呼び出し回数";
+            m_Strings["totalTime"] = "合計時間";
+            m_Strings["allocCount"] = "ヒープ確保回数";
+            m_Strings["allocBytes"] = "確保バイト数";
+            m_Strings["freeCount"] = "ヒープ解放回数";
+            m_Strings["perfCycles"] = "CPUサイクル数";
+            m_Strings["perfInstructions"] = "実行命令数";
+            m_Strings["perfIpc"] = "IPC";
+            m_Strings["perfCacheMisses"] = "キャッシュミス数";
+            m_Strings["perfBranchMisses"] = "分岐予測ミス数";
+            m_Strings["perfContextSwitches"] = "コンテキストスイッチ数";
+            m_Strings["perfTaskClock"] = "CPU時間";
+            m_Strings["perfPageFaults"] = "ページフォルト数";
+            m_Strings["omittedElements"] = "省略された要素数";
+            m_Strings["elementCount"] = "要素数";
+            m_Strings["minimum"] = "最小値";
+            m_Strings["maximum"] = "最大値";
+            m_Strings["mean"] = "平均";
+            m_Strings["stddev"] = "標準偏差";
+            m_Strings["nanCount"] = "NaN の数";
+            m_Strings["infCount"] = "無限大の数";
+            m_Strings["histogram"] = "分布";
+            m_Strings["memory"] = "メモリ";
+            m_Strings["byteSize"] = "バイト数";
+            m_Strings["omittedBytes"] = "省略されたバイト数";
+            m_Strings["watchFrame"] = "監視フレーム";
+            m_Strings["captureTime"] = "記録時刻";
+            m_Strings["captureReadFailed"] = "記録ファイルを読み込めません";
+            m_Strings["suppressedOutput"] = "抑制された出力";
+            m_Strings["suppressedCount"] = "抑制回数";
+            m_Strings["messageRepeated"] = "直前のメッセージの繰り返し回数";
+            m_Strings["throttledOutput"] = "出力量の上限を超えたため間引いた呼び出し箇所";
+            m_Strings["popupRepeated"] = "同じポップアップの発生回数";
+            m_Strings["popupSuppressed"] = "ポップアップの表示数が上限に達したためコンソールにのみ表示します";
+            m_Strings["popupUnavailable"] = "ダイアログを表示できない環境のためコンソールに表示します";
+            m_Strings["captureLimitReached"] = "構造体の記録が上限のバイト数に達したため、以降の記録を破棄します";
         }
 
         std::string m_Language = "ja";       // 現在の言語コード
         std::string m_LanguagePath = DEBUGPRINT_DEFAULT_LANG_PATH;  // 言語ファイルのディレクトリパス
 
         std::unordered_map<std::string, std::string> m_Strings;  // 文字列テーブル
+        std::atomic<uint64_t> m_Generation{ 0 };  // 文字列テーブルの世代番号
     };
 
     // 文字列キーの定数
@@ -169,6 +222,49 @@ namespace DebugPrint
     inline const std::string keyOpen = "open";
     inline const std::string keyClose = "close";
     inline const std::string keyErrorDialogTitle = "errorDialogTitle";
+    inline const std::string keyClassReport = "classReport";
+    inline const std::string keyLiveCount = "liveCount";
+    inline const std::string keyPeakCount = "peakCount";
+    inline const std::string keyTotalConstructed = "totalConstructed";
+    inline const std::string keyLifetimeHistogram = "lifetimeHistogram";
+    inline const std::string keyLeakDetected = "leakDetected";
+    inline const std::string keyScopeProfile = "scopeProfile";
+    inline const std::string keyCallCount = "callCount";
+    inline const std::string keyTotalTime = "totalTime";
+    inline const std::string keyAllocCount = "allocCount";
+    inline const std::string keyAllocBytes = "allocBytes";
+    inline const std::string keyFreeCount = "freeCount";
+    inline const std::string keyPerfCycles = "perfCycles";
+    inline const std::string keyPerfInstructions = "perfInstructions";
+    inline const std::string keyPerfIpc = "perfIpc";
+    inline const std::string keyPerfCacheMisses = "perfCacheMisses";
+    inline const std::string keyPerfBranchMisses = "perfBranchMisses";
+    inline const std::string keyPerfContextSwitches = "perfContextSwitches";
+    inline const std::string keyPerfTaskClock = "perfTaskClock";
+    inline const std::string keyPerfPageFaults = "perfPageFaults";
+    inline const std::string keyOmittedElements = "omittedElements";
+    inline const std::string keyElementCount = "elementCount";
+    inline const std::string keyMinimum = "minimum";
+    inline const std::string keyMaximum = "maximum";
+    inline const std::string keyMean = "mean";
+    inline const std::string keyStddev = "stddev";
+    inline const std::string keyNanCount = "nanCount";
+    inline const std::string keyInfCount = "infCount";
+    inline const std::string keyHistogram = "histogram";
+    inline const std::string keyMemory = "memory";
+    inline const std::string keyByteSize = "byteSize";
+    inline const std::string keyOmittedBytes = "omittedBytes";
+    inline const std::string keyWatchFrame = "watchFrame";
+    inline const std::string keyCaptureTime = "captureTime";
+    inline const std::string keyCaptureReadFailed = "captureReadFailed";
+    inline const std::string keySuppressedOutput = "suppressedOutput";
+    inline const std::string keySuppressedCount = "suppressedCount";
+    inline const std::string keyMessageRepeated = "messageRepeated";
+    inline const std::string keyThrottledOutput = "throttledOutput";
+    inline const std::string keyPopupRepeated = "popupRepeated";
+    inline const std::string keyPopupSuppressed = "popupSuppressed";
+    inline const std::string keyPopupUnavailable = "popupUnavailable";
+    inline const std::string keyCaptureLimitReached = "captureLimitReached";
 
     // 各文字列へのアクセス用インライン関数
     inline const std::string& datetimeFormat() { return TemplateStrings::GetInstance().Get(keyDatetimeFormat); }
@@ -188,5 +284,48 @@ namespace DebugPrint
     inline const std::string& openString() { return TemplateStrings::GetInstance().Get(keyOpen); }
     inline const std::string& closeString() { return TemplateStrings::GetInstance().Get(keyClose); }
     inline const std::string& errorDialogTitle() { return TemplateStrings::GetInstance().Get(keyErrorDialogTitle); }
+    inline const std::string& classReportString() { return TemplateStrings::GetInstance().Get(keyClassReport); }
+    inline const std::string& liveCountString() { return TemplateStrings::GetInstance().Get(keyLiveCount); }
+    inline const std::string& peakCountString() { return TemplateStrings::GetInstance().Get(keyPeakCount); }
+    inline const std::string& totalConstructedString() { return TemplateStrings::GetInstance().Get(keyTotalConstructed); }
+    inline const std::string& lifetimeHistogramString() { return TemplateStrings::GetInstance().Get(keyLifetimeHistogram); }
+    inline const std::string& leakDetectedString() { return TemplateStrings::GetInstance().Get(keyLeakDetected); }
+    inline const std::string& scopeProfileString() { return TemplateStrings::GetInstance().Get(keyScopeProfile); }
+    inline const std::string& callCountString() { return TemplateStrings::GetInstance().Get(keyCallCount); }
+    inline const std::string& totalTimeString() { return TemplateStrings::GetInstance().Get(keyTotalTime); }
+    inline const std::string& allocCountString() { return TemplateStrings::GetInstance().Get(keyAllocCount); }
+    inline const std::string& allocBytesString() { return TemplateStrings::GetInstance().Get(keyAllocBytes); }
+    inline const std::string& freeCountString() { return TemplateStrings::GetInstance().Get(keyFreeCount); }
+    inline const std::string& perfCyclesString() { return TemplateStrings::GetInstance().Get(keyPerfCycles); }
+    inline const std::string& perfInstructionsString() { return TemplateStrings::GetInstance().Get(keyPerfInstructions); }
+    inline const std::string& perfIpcString() { return TemplateStrings::GetInstance().Get(keyPerfIpc); }
+    inline const std::string& perfCacheMissesString() { return TemplateStrings::GetInstance().Get(keyPerfCacheMisses); }
+    inline const std::string& perfBranchMissesString() { return TemplateStrings::GetInstance().Get(keyPerfBranchMisses); }
+    inline const std::string& perfContextSwitchesString() { return TemplateStrings::GetInstance().Get(keyPerfContextSwitches); }
+    inline const std::string& perfTaskClockString() { return TemplateStrings::GetInstance().Get(keyPerfTaskClock); }
+    inline const std::string& perfPageFaultsString() { return TemplateStrings::GetInstance().Get(keyPerfPageFaults); }
+    inline const std::string& omittedElementsString() { return TemplateStrings::GetInstance().Get(keyOmittedElements); }
+    inline const std::string& elementCountString() { return TemplateStrings::GetInstance().Get(keyElementCount); }
+    inline const std::string& minimumString() { return TemplateStrings::GetInstance().Get(keyMinimum); }
+    inline const std::string& maximumString() { return TemplateStrings::GetInstance().Get(keyMaximum); }
+    inline const std::string& meanString() { return TemplateStrings::GetInstance().Get(keyMean); }
+    inline const std::string& stddevString() { return TemplateStrings::GetInstance().Get(keyStddev); }
+    inline const std::string& nanCountString() { return TemplateStrings::GetInstance().Get(keyNanCount); }
+    inline const std::string& infCountString() { return TemplateStrings::GetInstance().Get(keyInfCount); }
+    inline const std::string& histogramString() { return TemplateStrings::GetInstance().Get(keyHistogram); }
+    inline const std::string& memoryString() { return TemplateStrings::GetInstance().Get(keyMemory); }
+    inline const std::string& byteSizeString() { return TemplateStrings::GetInstance().Get(keyByteSize); }
+    inline const std::string& omittedBytesString() { return TemplateStrings::GetInstance().Get(keyOmittedBytes); }
+    inline const std::string& watchFrameString() { return TemplateStrings::GetInstance().Get(keyWatchFrame); }
+    inline const std::string& captureTimeString() { return TemplateStrings::GetInstance().Get(keyCaptureTime); }
+    inline const std::string& captureReadFailedString() { return TemplateStrings::GetInstance().Get(keyCaptureReadFailed); }
+    inline const std::string& suppressedOutputString() { return TemplateStrings::GetInstance().Get(keySuppressedOutput); }
+    inline const std::string& suppressedCountString() { return TemplateStrings::GetInstance().Get(keySuppressedCount); }
+    inline const std::string& messageRepeatedString() { return TemplateStrings::GetInstance().Get(keyMessageRepeated); }
+    inline const std::string& throttledOutputString() { return TemplateStrings::GetInstance().Get(keyThrottledOutput); }
+    inline const std::string& popupRepeatedString() { return TemplateStrings::GetInstance().Get(keyPopupRepeated); }
+    inline const std::string& popupSuppressedString() { return TemplateStrings::GetInstance().Get(keyPopupSuppressed); }
+    inline const std::string& popupUnavailableString() { return TemplateStrings::GetInstance().Get(keyPopupUnavailable); }
+    inline const std::string& captureLimitReachedString() { return TemplateStrings::GetInstance().Get(keyCaptureLimitReached); }
 
 } // namespace DebugPrint
\ No newline at end of file
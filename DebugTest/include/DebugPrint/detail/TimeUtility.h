@@ -1,13 +1,32 @@
 #pragma once
 #include <chrono>        // 時間取得用
+#include <cstdint>
 #include <ctime>         // 時間処理用
 #include <iomanip>       // 出力フォーマット用
 #include <sstream>       // 文字列ストリーム用
 #include <string>
 #include "TemplateStrings.h"
 
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>  // emscripten_get_now 用
+#endif
+
 namespace DebugPrint
 {
+    /// @brief 単調増加する現在時刻をナノ秒単位で取得する。
+    /// Emscripten では libc の clock_gettime を経由せず、performance.now() を直接読む emscripten_get_now() を使う。
+    /// それ以外は steady_clock を使う
+    /// @return 現在時刻(ナノ秒)。基準点は環境ごとに異なるため、差分のみに意味がある
+    [[nodiscard]] inline uint64_t GetMonotonicNanoseconds()
+    {
+#if defined(__EMSCRIPTEN__)
+        return static_cast<uint64_t>(emscripten_get_now() * 1000000.0);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
     /// @brief 現在時刻を指定フォーマットの文字列で取得する。
     /// timeFormat が nullptr の場合は TemplateStrings から日時フォーマットを取得する。
     /// Windows では localtime_s、それ以外では localtime_r を使用する
@@ -47,6 +66,7 @@ namespace DebugPrint
 
     /// @brief 経過時間を計測するクラス。
     /// Start() で計測を開始し、GetElapsedSecTime() で経過時間を秒単位の文字列で取得する。
+    /// 時刻の巻き戻りの影響を受けないよう GetMonotonicNanoseconds() で計測する。
     /// FunctionTracer から関数の実行時間計測に使用する
     class Timer
     {
@@ -54,16 +74,29 @@ namespace DebugPrint
         /// @brief 経過時間の計測を開始する
         void Start()
         {
-            m_Start = std::chrono::system_clock::now();
+            m_Start = GetMonotonicNanoseconds();
+        }
+
+        /// @brief Start() を呼び出した時刻を GetMonotonicNanoseconds() の値で取得する。
+        /// Emscripten では performance.now() と同じ時間軸のため、User Timing の開始時刻に使える
+        /// @return 計測開始時刻(ナノ秒)
+        [[nodiscard]] uint64_t GetStartNanoseconds() const
+        {
+            return m_Start;
+        }
+
+        /// @brief Start() からの経過時間をナノ秒単位で取得する
+        /// @return 経過時間(ナノ秒)
+        [[nodiscard]] uint64_t GetElapsedNanoseconds() const
+        {
+            return GetMonotonicNanoseconds() - m_Start;
         }
 
         /// @brief Start() からの経過時間を "秒.ミリ秒" 形式の文字列で取得する
         /// @return 経過時間の文字列 ("1.234" など)
         [[nodiscard]] std::string GetElapsedSecTime()
         {
-            auto now      = std::chrono::system_clock::now();
-            auto duration = now - m_Start;
-            auto ms       = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+            auto ms       = GetElapsedNanoseconds() / 1000000;
             auto sec      = ms / 1000;
             auto msec     = ms % 1000;
 
@@ -73,7 +106,7 @@ namespace DebugPrint
         }
 
     private:
-        std::chrono::system_clock::time_point m_Start;  // 計測開始時刻
+        uint64_t m_Start = 0;  // 計測開始時刻(GetMonotonicNanoseconds() の値)
     };
 
 } // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,295 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "PrintFunction.h"
+#include "TemplateStrings.h"
+#include "PrintVariable.h"
+#include "FormatBuffer.h"
+
+namespace DebugPrint
+{
+    /// @brief PRINT_WATCH で登録した変数を保持し、DEBUG_WATCH_TICK のたびに
+    /// 前回から変化した変数だけを "前 -> 後" の形式で表示するシングルトンクラス。
+    /// トリビアルにコピー可能な型は全変数分のスナップショットを1つの連続したバッファに保持し、
+    /// 確認時は memcmp だけで変化を判定する。それ以外の型は値の複製を == 演算子で比較し、
+    /// == 演算子やコピーができない型は書式化した文字列で比較する。
+    /// 登録した変数のアドレスを保持するため、寿命の短い変数は DEBUG_UNWATCH で登録を解除すること
+    class WatchRegistry
+    {
+    public:
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static WatchRegistry& GetInstance()
+        {
+            static WatchRegistry instance;
+            return instance;
+        }
+
+        /// @brief 変数を監視対象に登録し、現在の値をスナップショットとして保存する。
+        /// 同じアドレス・同じ型の変数が登録済みの場合は何もしないため、毎フレーム呼び出してもよい。
+        /// 構造体とその先頭のメンバのようにアドレスが同じでも、型が異なれば別の変数として登録する
+        /// @param name 変数名の文字列
+        /// @param var 監視する変数
+        template <typename T>
+        void Watch(const char* name, const T& var)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const void* address = static_cast<const void*>(std::addressof(var));
+            if (Find(address, TypeKey<T>()) != m_Indices.end()) return;
+
+            WatchEntry entry;
+            entry.name    = name;
+            entry.address = address;
+            entry.typeKey = TypeKey<T>();
+            entry.format  = &FormatValue<T>;
+
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                entry.size           = sizeof(T);
+                entry.snapshotOffset = AllocateSnapshot(sizeof(T));
+                std::memcpy(m_Snapshots.data() + entry.snapshotOffset, address, sizeof(T));
+            }
+            else if constexpr (std::equality_comparable<T> && std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>)
+            {
+                entry.copy        = std::make_shared<T>(var);
+                entry.checkUpdate = &CheckAndUpdateCopy<T>;
+            }
+            else
+            {
+                auto text = std::make_shared<std::string>();
+                FormatValue<T>(*text, address);
+                entry.copy        = std::move(text);
+                entry.checkUpdate = &CheckAndUpdateText<T>;
+            }
+
+            m_Indices.emplace(address, m_Entries.size());
+            m_Entries.push_back(std::move(entry));
+        }
+
+        /// @brief 変数の監視を解除する
+        /// @param var 監視を解除する変数
+        template <typename T>
+        void Unwatch(const T& var)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const auto it = Find(static_cast<const void*>(std::addressof(var)), TypeKey<T>());
+            if (it == m_Indices.end()) return;
+
+            m_Entries.erase(m_Entries.begin() + static_cast<std::ptrdiff_t>(it->second));
+            RebuildIndex();
+        }
+
+        /// @brief 全変数の監視を解除する
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Entries.clear();
+            m_Indices.clear();
+            m_Snapshots.clear();
+            m_FrameCount = 0;
+        }
+
+        /// @brief 監視中の全変数を前回の値と比較し、変化した変数をまとめて1回で表示する。
+        /// 変化がない場合は何も表示しない。1フレームに1回呼び出す
+        void Tick()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_FrameCount;
+
+            ScopedFormatBuffer buffer;
+            std::string& out = buffer.Get();
+            out += separatorString();
+            out += watchFrameString();
+            out += pairSeparatorString();
+            AppendValue(out, m_FrameCount);
+            out += '\n';
+            const std::size_t headerLength = out.size();
+
+            for (WatchEntry& entry : m_Entries)
+            {
+                if (entry.size > 0)
+                {
+                    std::byte* snapshot = m_Snapshots.data() + entry.snapshotOffset;
+                    if (std::memcmp(snapshot, entry.address, entry.size) == 0) continue;
+
+                    const std::size_t lineStart = out.size();
+                    AppendLineHead(out, entry);
+                    const std::size_t beforeStart = out.size();
+                    entry.format(out, snapshot);
+                    const std::size_t beforeLength = out.size() - beforeStart;
+                    out += " -> ";
+                    const std::size_t afterStart = out.size();
+                    entry.format(out, entry.address);
+                    std::memcpy(snapshot, entry.address, entry.size);
+
+                    // パディングのみが変化した場合は表示が同じになるため取り消す
+                    if (out.size() - afterStart == beforeLength &&
+                        out.compare(afterStart, beforeLength, out, beforeStart, beforeLength) == 0)
+                    {
+                        out.resize(lineStart);
+                        continue;
+                    }
+                    out += '\n';
+                }
+                else
+                {
+                    const std::size_t lineStart = out.size();
+                    AppendLineHead(out, entry);
+                    if (!entry.checkUpdate(out, entry.copy.get(), entry.address))
+                    {
+                        out.resize(lineStart);
+                        continue;
+                    }
+                    out += '\n';
+                }
+            }
+
+            if (out.size() == headerLength) return;
+            out += separatorString();
+            PrintMessage(out);
+        }
+
+        // コピー・ムーブ禁止
+        WatchRegistry(const WatchRegistry&) = delete;
+        WatchRegistry& operator=(const WatchRegistry&) = delete;
+        WatchRegistry(WatchRegistry&&) = delete;
+        WatchRegistry& operator=(WatchRegistry&&) = delete;
+
+    private:
+
+        /// @brief 監視中の変数1つ分の情報
+        struct WatchEntry
+        {
+            std::string name;                 // 変数名
+            const void* address = nullptr;    // 変数のアドレス
+            const void* typeKey = nullptr;    // 変数の型を識別する値(TypeKey の戻り値)
+            std::size_t size = 0;             // スナップショットのバイト数(トリビアルにコピー可能な型以外は0)
+            std::size_t snapshotOffset = 0;   // m_Snapshots 内のスナップショットの位置
+            std::shared_ptr<void> copy;       // トリビアルにコピー可能な型以外の前回の値(値の複製または書式化した文字列)
+            void (*format)(std::string&, const void*) = nullptr;  // 変数の値を書式化する関数
+            bool (*checkUpdate)(std::string&, void*, const void*) = nullptr;  // copy と比較し、変化していれば "前 -> 後" を追加して更新する関数
+        };
+
+        WatchRegistry()
+        {
+            // Tick で使用するシングルトンを先に生成し、このインスタンスより後に破棄されるようにする
+            (void)DebugPrintConfig::GetInstance();
+            (void)TemplateStrings::GetInstance();
+        }
+
+        /// @brief 型ごとに異なる値を返す。同じアドレスの異なる型の変数を区別するために使う
+        template <typename T>
+        static const void* TypeKey()
+        {
+            static const char key = 0;
+            return &key;
+        }
+
+        /// @brief アドレスと型が一致する登録済みの変数を探す
+        /// @return m_Indices の要素(見つからない場合は end())
+        std::unordered_multimap<const void*, std::size_t>::iterator Find(const void* address, const void* typeKey)
+        {
+            auto [first, last] = m_Indices.equal_range(address);
+            for (; first != last; ++first)
+            {
+                if (m_Entries[first->second].typeKey == typeKey) return first;
+            }
+            return m_Indices.end();
+        }
+
+        /// @brief 値を PRINT_VARIABLE と同じ1行の書式でバッファに追加する
+        template <typename T>
+        static void FormatValue(std::string& out, const void* value)
+        {
+            AppendFormatted(out, *static_cast<const T*>(value), 0, GetPrintLimits());
+        }
+
+        /// @brief 値の複製と == 演算子で比較し、変化していれば "前 -> 後" を追加して複製を更新する
+        template <typename T>
+        static bool CheckAndUpdateCopy(std::string& out, void* copy, const void* address)
+        {
+            T& previous = *static_cast<T*>(copy);
+            const T& current = *static_cast<const T*>(address);
+            if (previous == current) return false;
+
+            AppendFormatted(out, previous, 0, GetPrintLimits());
+            out += " -> ";
+            AppendFormatted(out, current, 0, GetPrintLimits());
+            previous = current;
+            return true;
+        }
+
+        /// @brief 前回書式化した文字列と比較し、変化していれば "前 -> 後" を追加して文字列を更新する
+        template <typename T>
+        static bool CheckAndUpdateText(std::string& out, void* copy, const void* address)
+        {
+            std::string& previous = *static_cast<std::string*>(copy);
+            std::string current;
+            FormatValue<T>(current, address);
+            if (previous == current) return false;
+
+            out += previous;
+            out += " -> ";
+            out += current;
+            previous = std::move(current);
+            return true;
+        }
+
+        /// @brief 変化した変数の行の先頭("変数: 名前  値: ")を追加する
+        static void AppendLineHead(std::string& out, const WatchEntry& entry)
+        {
+            out += variableString();
+            out += pairSeparatorString();
+            out += entry.name;
+            out += "  ";
+            out += valueString();
+            out += pairSeparatorString();
+        }
+
+        /// @brief スナップショット用の領域を連続したバッファの末尾に確保する。
+        /// 任意の型として読めるよう、位置は max_align_t の境界に揃える
+        /// @param size バイト数
+        /// @return 確保した領域の位置
+        std::size_t AllocateSnapshot(std::size_t size)
+        {
+            constexpr std::size_t alignment = alignof(std::max_align_t);
+            const std::size_t offset = (m_Snapshots.size() + alignment - 1) / alignment * alignment;
+            m_Snapshots.resize(offset + size);
+            return offset;
+        }
+
+        /// @brief 登録解除後に添字の表を作り直し、スナップショットのバッファを詰め直す
+        void RebuildIndex()
+        {
+            std::vector<std::byte> snapshots;
+            snapshots.swap(m_Snapshots);
+            m_Indices.clear();
+            for (std::size_t i = 0; i < m_Entries.size(); ++i)
+            {
+                WatchEntry& entry = m_Entries[i];
+                m_Indices.emplace(entry.address, i);
+                if (entry.size > 0)
+                {
+                    const std::size_t offset = AllocateSnapshot(entry.size);
+                    std::memcpy(m_Snapshots.data() + offset, snapshots.data() + entry.snapshotOffset, entry.size);
+                    entry.snapshotOffset = offset;
+                }
+            }
+        }
+
+        std::mutex m_Mutex;  // 全メンバーの排他制御用
+        std::vector<WatchEntry> m_Entries;  // 監視中の変数(登録順)
+        std::unordered_multimap<const void*, std::size_t> m_Indices;  // アドレスから m_Entries の添字への表(同じアドレスの異なる型を含む)
+        std::vector<std::byte> m_Snapshots;  // トリビアルにコピー可能な型のスナップショット(全変数分を連続して保持)
+        uint64_t m_FrameCount = 0;  // Tick の呼び出し回数
+    };
+
+} // namespace DebugPrint
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include "ColorDefine.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+#include "EmscriptenFunctions.h"
+
+namespace DebugPrint
+{
+    // 前方宣言(PrintFunction.h で定義する)
+    inline std::mutex& GetOutputMutex();
+
+    /// @brief Emscripten 環境で、出力するメッセージを wasm の線形メモリ上のリングバッファに溜めるシングルトンクラス。
+    /// メッセージごとに JavaScript を呼び出して UTF8ToString で文字列を作る代わりに、
+    /// UTF-8 のバイト列をそのまま書き込み、JavaScript 側がまとめて取り出して TextDecoder で一括してデコードする。
+    /// JavaScript を呼び出すのは、空のリングバッファに最初のメッセージを書き込んだとき(取り出しの予約)と、
+    /// リングバッファが一杯になったとき(その場での取り出し)だけになる。
+    /// メンバーはすべてトリビアルに破棄できる型のため、終了時に他のシングルトンが出力しても安全に使える
+    class WebOutputRing
+    {
+    public:
+
+        static constexpr uint32_t kTextCapacity   = 1u << 18;            // 文字列領域のバイト数(2のべき乗)
+        static constexpr uint32_t kRecordCapacity = 1u << 12;            // 記録できるメッセージ数(2のべき乗)
+        static constexpr uint32_t kMaxRecordBytes = kTextCapacity / 4;   // リングバッファを通す最大のメッセージのバイト数
+        static constexpr uint32_t kRecordWords    = 6;                   // 1件の記録の uint32_t の個数
+
+        /// @brief シングルトンのインスタンスを取得する
+        [[nodiscard]] static WebOutputRing& GetInstance()
+        {
+            static WebOutputRing instance;
+            return instance;
+        }
+
+        /// @brief メッセージをリングバッファに書き込む。
+        /// 大きすぎるメッセージは、溜まっている分を先に出力してから直接 JavaScript に渡す
+        /// @param message 出力するメッセージ(UTF-8)
+        /// @param color 表示色
+        /// @param toStderr 標準エラー出力に出力する場合は true
+        void Write(const std::string& message, Color color, bool toStderr)
+        {
+            if (message.empty()) return;
+
+            std::lock_guard<std::mutex> lock(GetOutputMutex());
+            if (message.size() > kMaxRecordBytes)
+            {
+                js_output_ring_drain();
+                if (toStderr)
+                {
+                    js_print_error(message.c_str(), color);
+                }
+                else
+                {
+                    js_print(message.c_str(), color);
+                }
+                return;
+            }
+
+            const uint32_t size = static_cast<uint32_t>(message.size());
+            uint32_t offset = m_TextWrite % kTextCapacity;
+            uint32_t skip   = offset + size > kTextCapacity ? kTextCapacity - offset : 0;
+            if (!HasSpace(skip + size))
+            {
+                // JavaScript 側の取り出しが追いつかない場合は、その場で取り出してもらう
+                js_output_ring_drain();
+                offset = m_TextWrite % kTextCapacity;
+                skip   = offset + size > kTextCapacity ? kTextCapacity - offset : 0;
+            }
+
+            // 1件のメッセージが末尾で分かれないよう、収まらない場合は先頭から書き込む
+            const uint32_t start = skip > 0 ? 0 : offset;
+            std::memcpy(m_Text + start, message.data(), size);
+            m_TextWrite += skip + size;
+
+            const uint32_t recordWrite = m_Header[kRecordWrite].load(std::memory_order_relaxed);
+            uint32_t* record = m_Records + (recordWrite % kRecordCapacity) * kRecordWords;
+            record[0] = start;
+            record[1] = size;
+            record[2] = CountUtf16Units(message);
+            record[3] = static_cast<uint32_t>(color);
+            record[4] = toStderr ? 1u : 0u;
+            record[5] = m_TextWrite;
+            m_Header[kRecordWrite].store(recordWrite + 1, std::memory_order_release);
+
+            if (m_Header[kScheduled].exchange(1, std::memory_order_acq_rel) == 0)
+            {
+                js_output_ring_schedule();
+            }
+        }
+
+        // コピー・ムーブ禁止
+        WebOutputRing(const WebOutputRing&) = delete;
+        WebOutputRing& operator=(const WebOutputRing&) = delete;
+        WebOutputRing(WebOutputRing&&) = delete;
+        WebOutputRing& operator=(WebOutputRing&&) = delete;
+
+    private:
+
+        // m_Header の各要素の位置。JavaScript 側も同じ位置を読み書きする
+        static constexpr int kRecordWrite = 0;  // 次に書き込む記録の通し番号
+        static constexpr int kRecordRead  = 1;  // 次に取り出す記録の通し番号(JavaScript 側が更新する)
+        static constexpr int kTextRead    = 2;  // 取り出し済みの文字列領域の位置(JavaScript 側が更新する)
+        static constexpr int kScheduled   = 3;  // 取り出しを予約済みかどうか(JavaScript 側が取り出し時に 0 に戻す)
+
+        /// @brief コンストラクタ。リングバッファの位置を JavaScript 側に登録する
+        WebOutputRing()
+        {
+            js_register_output_ring(
+                reinterpret_cast<uint32_t*>(m_Header), m_Records, kRecordCapacity, m_Text, kTextCapacity);
+        }
+
+        /// @brief 文字列と記録を書き込む空きがあるかを判定する
+        /// @param bytes 文字列領域に書き込むバイト数(先頭に戻るために飛ばす分を含む)
+        bool HasSpace(uint32_t bytes) const
+        {
+            const uint32_t textUsed   = m_TextWrite - m_Header[kTextRead].load(std::memory_order_acquire);
+            const uint32_t recordUsed = m_Header[kRecordWrite].load(std::memory_order_relaxed) -
+                                        m_Header[kRecordRead].load(std::memory_order_acquire);
+            return kTextCapacity - textUsed >= bytes && recordUsed < kRecordCapacity;
+        }
+
+        /// @brief UTF-8 の文字列を JavaScript の文字列にしたときの長さ(UTF-16 のコード単位数)を数える。
+        /// JavaScript 側はまとめてデコードした文字列をこの長さで各メッセージに切り分ける
+        static uint32_t CountUtf16Units(const std::string& message)
+        {
+            uint32_t units = 0;
+            for (const char c : message)
+            {
+                const unsigned char byte = static_cast<unsigned char>(c);
+                if ((byte & 0xC0) != 0x80) units += byte >= 0xF0 ? 2 : 1;
+            }
+            return units;
+        }
+
+        alignas(4) std::atomic<uint32_t> m_Header[4] = {};  // JavaScript 側と共有する読み書きの位置
+        uint32_t m_Records[kRecordCapacity * kRecordWords] = {};  // 各メッセージの位置・バイト数・長さ・色・出力先・終端
+        uint8_t  m_Text[kTextCapacity] = {};  // メッセージの UTF-8 のバイト列
+        uint32_t m_TextWrite = 0;             // 文字列領域に次に書き込む位置(通し番号)
+    };
+
+} // namespace DebugPrint
+
+#endif
\ No newline at end of file
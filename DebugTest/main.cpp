@@ -1,12 +1,22 @@
 #define DEBUG_PRINT_IMPLEMENTATION
+#define DEBUG_PRINT_TRACK_ALLOCATIONS
 
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <array>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <variant>
 #include <string>
 #include "DebugPrint/DebugPrint.h"
 
+// メッセージ表示マクロは名前空間スコープの変数の初期化式の中でも使える
+[[maybe_unused]] static const int staticInitMessage = (PRINT_MESSAGE("PRINT_MESSAGE: 静的初期化の中でも使える\n"), 0);
+
 // クラストレースのテスト用クラス
 class HogeClass
 {
@@ -52,6 +62,32 @@ struct Transform
     float rotation;
 };
 
+// JSON 出力用の構造体(コンテナ・省略可能な値を含む)
+struct Entity
+{
+    std::string                name;
+    Transform                  transform;
+    Player                     player;
+    std::vector<int>           tags;
+    std::map<std::string, int> stats;
+    std::optional<float>       target;
+};
+
+// 関数トレースのテスト用関数
+float TraceTestFunction(int count)
+{
+    PRINT_TRACE_FUNCTION;
+
+    std::vector<float> values(count);
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i)
+    {
+        values[i] = static_cast<float>(i) * 0.5f;
+        sum += values[i];
+    }
+    return sum;
+}
+
 int main(int argc, char* argv[])
 {
     PRINT_TRACE_FUNCTION;
@@ -68,9 +104,19 @@ int main(int argc, char* argv[])
     DEBUG_SET_POPUP_MESSAGE_COLOR(PRINT_COLOR::DEFAULT);
     DEBUG_SET_POPUP_WARNING_MESSAGE_COLOR(PRINT_COLOR::YELLOW);
     DEBUG_SET_POPUP_ERROR_MESSAGE_COLOR(PRINT_COLOR::BRIGHT_RED);
+    DEBUG_SET_SCOPE_PROFILE_REPORT(true);
+    DEBUG_SET_PERF_COUNTERS(true);
+    DEBUG_SET_FLAME_GRAPH(true);
 
     // ===== クラストレースのテスト =====
+    // 統計はプログラム終了時にまとめて出力される
     HogeClass hoge;
+    {
+        std::vector<HogeClass> hogeList(3);  // 最大生存数・寿命分布の確認用
+    }
+
+    // ===== 関数トレースのテスト =====
+    TraceTestFunction(100000);
 
     // ===== 通常メッセージのテスト =====
     PRINT_MESSAGE("PRINT_MESSAGE: 通常メッセージ\n");
@@ -81,12 +127,50 @@ int main(int argc, char* argv[])
     std::vector<std::string> nameList = { "Alice", "Bob" };
     std::array<float, 3>     ary = { 3.14f, 2.71f, 1.61f };
     TestEnum                 enumVal = TestEnum::VALUE_B;
+    char                     tag[4] = { 'a', 'b', 'c', 'd' };  // 終端の '\0' がない char 配列
 
     PRINT_VARIABLE(a);
     PRINT_VARIABLE(arr);
     PRINT_VARIABLE(nameList);
     PRINT_VARIABLE(ary);
     PRINT_VARIABLE(enumVal);  // magic_enum により "VALUE_B" と表示される
+    PRINT_VARIABLE(tag);      // 配列の長さまでの "abcd" と表示される
+
+    // ===== コンテナ表示のテスト =====
+    std::map<std::string, int>        scoreMap = { { "Alice", 90 }, { "Bob", 75 } };
+    std::vector<std::vector<int>>     grid     = { { 1, 2 }, { 3, 4 } };
+    std::pair<int, std::string>       idName   = { 1, "Alice" };
+    std::tuple<int, float, TestEnum>  record   = { 2, 0.5f, TestEnum::VALUE_C };
+    std::optional<int>                maybe;
+    std::variant<int, std::string>    either   = std::string("text");
+    std::vector<int>                  bigList(100000, 7);
+
+    PRINT_VARIABLE(scoreMap);  // キーが添字の代わりに表示される
+    PRINT_VARIABLE(grid);      // 入れ子のコンテナは {1, 2} の形式で表示される
+    PRINT_VARIABLE(idName);
+    PRINT_VARIABLE(record);
+    PRINT_VARIABLE(maybe);
+    PRINT_VARIABLE(either);
+    DEBUG_SET_PRINT_MAX_ELEMENTS(6);
+    PRINT_VARIABLE(bigList);   // 先頭と末尾の3要素ずつのみ表示される
+    DEBUG_SET_PRINT_MAX_ELEMENTS(100);
+
+    // ===== 数値配列の複数列表示のテスト =====
+    std::vector<int> samples(20);
+    for (int i = 0; i < 20; ++i) samples[i] = i * i * 37 - 500;
+    DEBUG_SET_PRINT_COLUMNS(8);
+    PRINT_VARIABLE(samples);
+    DEBUG_SET_PRINT_COLUMNS(1);
+
+    // ===== 数値配列の要約表示のテスト =====
+    std::vector<float> signal(100000);
+    for (std::size_t i = 0; i < signal.size(); ++i) signal[i] = std::sin(static_cast<float>(i) * 0.01f);
+    signal[123] = std::numeric_limits<float>::quiet_NaN();
+    PRINT_VARIABLE_SUMMARY(signal);  // 要素を表示せず、最小値・最大値・平均・NaN の数などを表示する
+
+    // ===== メモリダンプのテスト =====
+    unsigned char packet[80] = { 'G', 'E', 'T', ' ', '/', 'i', 'n', 'd', 'e', 'x', '.', 'h', 't', 'm', 'l', '\r', '\n' };
+    PRINT_MEMORY(packet, sizeof(packet));  // 同じ内容が続く行は "*" にまとめられる
 
 
     Vec3      vec = { 1.0f, 2.0f, 3.0f };
@@ -97,16 +181,102 @@ int main(int argc, char* argv[])
     PRINT_STRUCT(player);     // 列挙型メンバーも文字列で表示される
     PRINT_STRUCT(transform);  // ネストした Vec3 も再帰的に表示される
 
+    Entity entity = { "勇者", transform, player, { 1, 2, 3 }, { { "atk", 12 }, { "def", 8 } }, std::nullopt };
+    PRINT_STRUCT_JSON(entity);  // ネストした構造体・列挙型・コンテナも JSON で表示される
+
+    // ===== 構造体の差分表示のテスト =====
+    for (int tick = 0; tick < 4; ++tick)
+    {
+        if (tick == 2) transform.position.y += 0.5f;
+        if (tick == 3) transform.rotation = 90.0f;
+        PRINT_STRUCT_DIFF(transform);  // 初回は全メンバー、以降は変化したメンバーのみ表示される
+    }
+
+    // ===== 構造体の記録モードのテスト =====
+    DEBUG_SET_STRUCT_CAPTURE(true);
+    for (int tick = 0; tick < 3; ++tick)
+    {
+        player.dir = static_cast<Direction>(tick);
+        PRINT_STRUCT(player);     // 表示せずにバイト列のまま記録される
+        PRINT_STRUCT(transform);
+    }
+    DEBUG_SET_STRUCT_CAPTURE(false);
+    PRINT_STRUCT_CAPTURE_FILE(DEBUG_WRITE_STRUCT_CAPTURE("./logs/"));  // 書き出したファイルを復元して表示する
+    DEBUG_CLEAR_STRUCT_CAPTURE();
+
+    // ===== 変数監視のテスト =====
+    int         frameScore = 0;
+    std::string frameState = "idle";
+    PRINT_WATCH(frameScore);
+    PRINT_WATCH(frameState);
+    PRINT_WATCH(player);
+    for (int frame = 0; frame < 4; ++frame)
+    {
+        if (frame == 1) frameScore += 10;
+        if (frame == 2) frameState = "running";
+        if (frame == 3) player.hp -= 25.0f;
+        DEBUG_WATCH_TICK();  // 変化した変数のみ "前 -> 後" で表示される
+    }
+    DEBUG_CLEAR_WATCH();
+
 
     // ===== 警告・エラーメッセージのテスト =====
     PRINT_WARNING_MESSAGE("PRINT_WARNING_MESSAGE: 警告メッセージ\n");
     PRINT_ERROR_MESSAGE("PRINT_ERROR_MESSAGE: エラーメッセージ\n");
 
+    // ===== 出力の間引きのテスト =====
+    for (int i = 0; i < 100000; ++i)
+    {
+        PRINT_WARNING_MESSAGE_ONCE("PRINT_WARNING_MESSAGE_ONCE: 最初の1回だけ表示される\n");
+        PRINT_MESSAGE_EVERY_N(40000, "PRINT_MESSAGE_EVERY_N: 40000回に1回表示される\n");
+        PRINT_MESSAGE_EVERY_MS(1000, "PRINT_MESSAGE_EVERY_MS: 1秒に1回表示される\n");
+        i % 2 == 0 ? PRINT_MESSAGE_EVERY_N(40000, "PRINT_MESSAGE_EVERY_N: 条件演算子の中でも使える\n") : void();
+    }
+    DEBUG_PRINT_SUPPRESSED_SUMMARY();  // 抑制した回数を呼び出し箇所ごとに表示する
+
+    // ===== 連続する同じメッセージの省略のテスト =====
+    for (int i = 0; i < 1000; ++i)
+    {
+        PRINT_ERROR_MESSAGE("PRINT_ERROR_MESSAGE: ループ内のエラー\n");  // 2回目以降は表示されず、回数のみ表示される
+    }
+    PRINT_MESSAGE("連続が途切れると繰り返し回数が表示される\n");
+
+    // ===== 出力量の自動制限のテスト =====
+    DEBUG_SET_THROTTLE_MESSAGES_PER_SEC(5);
+    for (int i = 0; i < 100; ++i)
+    {
+        PRINT_MESSAGE("PRINT_MESSAGE: 上限を超えた分は自動で間引かれる " + std::to_string(i) + "\n");
+    }
+    DEBUG_PRINT_THROTTLE_REPORT();  // 間引いた回数の多い呼び出し箇所を表示する
+    DEBUG_SET_THROTTLE_MESSAGES_PER_SEC(1000);
+
+    // 1秒あたりのバイト数を超える大きなメッセージも、出力のなかった呼び出し箇所では1件は表示される
+    DEBUG_SET_THROTTLE_BYTES_PER_SEC(100);
+    for (int i = 0; i < 3; ++i)
+    {
+        PRINT_MESSAGE("PRINT_MESSAGE: 1秒あたりの上限を超える大きなメッセージ(1回目のみ表示される) " + std::string(100, '#') + "\n");
+    }
+    DEBUG_SET_THROTTLE_BYTES_PER_SEC(1 << 20);
+
+    // メッセージ表示マクロは式として使える
+    const bool throttleTestPassed = true;
+    throttleTestPassed ? PRINT_MESSAGE("PRINT_MESSAGE: 条件演算子の中でも使える\n")
+                       : PRINT_ERROR_MESSAGE("PRINT_ERROR_MESSAGE: 条件演算子の中でも使える\n");
+
     // ===== ポップアップのテスト =====
     POPUP_MESSAGE("POPUP_MESSAGE: 通常ポップアップ");
     POPUP_MESSAGE_ICON("POPUP_MESSAGE_ICON: 情報アイコン付きポップアップ", DebugPrint::PopupIcon::Info);
     POPUP_WARNING_MESSAGE("POPUP_WARNING_MESSAGE: 警告ポップアップ\n");
     POPUP_ERROR_MESSAGE("POPUP_ERROR_MESSAGE: エラーポップアップ\n");
+    POPUP_MESSAGE_BLOCKING("POPUP_MESSAGE_BLOCKING: 閉じられるまで待機するポップアップ");  // 先に積まれたポップアップの後に表示される
+    POPUP_MESSAGE_CALLBACK("POPUP_MESSAGE_CALLBACK: 閉じられた後に処理を行うポップアップ",
+        [] { PRINT_MESSAGE("POPUP_MESSAGE_CALLBACK: ポップアップが閉じられた\n"); });
+    DEBUG_SET_POPUP_MAX_PER_MINUTE(8);
+    for (int i = 0; i < 5; ++i)
+    {
+        POPUP_WARNING_MESSAGE("POPUP_WARNING_MESSAGE: 表示待ちの同じポップアップは1つにまとめられる\n");
+        POPUP_MESSAGE("POPUP_MESSAGE: 上限を超えた分はコンソールにのみ表示される " + std::to_string(i));
+    }
 
     // ===== ログのテスト =====
     DebugPrint::LogWriter::GetInstance().Add("[INFO]    アプリケーション開始");
@@ -129,5 +299,9 @@ int main(int argc, char* argv[])
         PRINT_MESSAGE("ログファイルの書き出しに失敗しました\n");
     }
 
+    // ===== フレームグラフのテスト =====
+    // flamegraph.pl などにそのまま渡せる折り畳みスタック形式で書き出す
+    DEBUG_WRITE_FLAME_GRAPH("./logs/trace.folded");
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file